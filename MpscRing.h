@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace mtm {
+
+    /**
+     * @brief Bounded lock-free queue with any number of producers and a single consumer.
+     *
+     * Every slot of the ring carries a sequence number that tells whose turn it is: a
+     * producer claims the next position with one compare-and-swap on the tail and publishes
+     * its value by bumping the slot's sequence, and the consumer takes slots in order
+     * without any read-modify-write. A full ring makes tryPush() fail instead of waiting,
+     * so the caller chooses how to apply back-pressure.
+     */
+    template<class T>
+    class MpscRing {
+        static_assert(std::is_nothrow_move_constructible<T>::value, "MpscRing needs a noexcept move constructor");
+
+    public:
+        /**
+         * @brief Creates an empty ring with room for capacity values, rounded up to a power of two.
+         *
+         * @throws std::invalid_argument If capacity is 0.
+         */
+        explicit MpscRing(std::size_t capacity);
+        ~MpscRing();
+
+        MpscRing(const MpscRing &other) = delete;
+        MpscRing &operator=(const MpscRing &other) = delete;
+
+        /**
+         * @brief Gets the number of values the ring holds when full.
+         */
+        std::size_t capacity() const;
+
+        /**
+         * @brief Moves a value into the ring. May be called from any thread.
+         *
+         * @return false, leaving value untouched, if the ring is full.
+         */
+        bool tryPush(T &&value);
+
+        /**
+         * @brief Gets the number of values pushed so far, including those already taken.
+         *
+         * Values pushed by calls that returned before this one are all counted; a push still
+         * in progress may be counted before it can be taken.
+         */
+        std::size_t pushed() const;
+
+        /**
+         * @brief Checks whether the consumer would find a value. Consumer only.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Takes up to max values in push order and passes each to function. Consumer only.
+         *
+         * A value leaves the ring before function sees it, so an exception thrown by
+         * function loses only that value.
+         *
+         * @return The number of values taken.
+         */
+        template<class Function>
+        std::size_t drain(std::size_t max, Function function);
+
+    private:
+        struct Slot {
+            std::atomic<std::size_t> m_sequence;
+            alignas(T) unsigned char m_storage[sizeof(T)];
+
+            T *value() {
+                return std::launder(reinterpret_cast<T *>(m_storage));
+            }
+        };
+
+        static const std::size_t CACHE_LINE = 64;
+
+        Slot *m_slots;
+        std::size_t m_mask;
+        alignas(CACHE_LINE) std::atomic<std::size_t> m_tail; // Next position a producer claims
+        alignas(CACHE_LINE) std::size_t m_head; // Next position the consumer takes
+    };
+
+    template<class T>
+    MpscRing<T>::MpscRing(std::size_t capacity) : m_slots(nullptr), m_mask(0), m_tail(0), m_head(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("MpscRing capacity must be positive");
+        }
+        std::size_t size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        m_slots = new Slot[size];
+        m_mask = size - 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template<class T>
+    MpscRing<T>::~MpscRing() {
+        drain(m_mask + 1, [](T &&) {
+        });
+        delete[] m_slots;
+    }
+
+    template<class T>
+    std::size_t MpscRing<T>::capacity() const {
+        return m_mask + 1;
+    }
+
+    /*
+     * A slot whose sequence equals the position is free for that position, one that lags
+     * behind still holds the value pushed a lap earlier, so the ring is full.
+     */
+    template<class T>
+    bool MpscRing<T>::tryPush(T &&value) {
+        std::size_t position = m_tail.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &m_slots[position & m_mask];
+            std::size_t sequence = slot->m_sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence - position);
+            if (lag == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        new (slot->m_storage) T(std::move(value));
+        slot->m_sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<class T>
+    std::size_t MpscRing<T>::pushed() const {
+        return m_tail.load(std::memory_order_relaxed);
+    }
+
+    template<class T>
+    bool MpscRing<T>::empty() const {
+        const Slot &slot = m_slots[m_head & m_mask];
+        return slot.m_sequence.load(std::memory_order_acquire) != m_head + 1;
+    }
+
+    template<class T>
+    template<class Function>
+    std::size_t MpscRing<T>::drain(std::size_t max, Function function) {
+        std::size_t taken = 0;
+        while (taken < max && !empty()) {
+            Slot &slot = m_slots[m_head & m_mask];
+            T value(std::move(*slot.value()));
+            slot.value()->~T();
+            // the slot is free for the producer one lap ahead
+            slot.m_sequence.store(m_head + m_mask + 1, std::memory_order_release);
+            m_head++;
+            taken++;
+            function(std::move(value));
+        }
+        return taken;
+    }
+
+} // namespace mtm
@@ -6,23 +6,50 @@ using std::endl;
 Person::Person(const string &name) : m_name(name) {}
 
 // Getters and setters
-string Person::getName() const {
+const string& Person::getName() const {
     return m_name;
 }
 
-const SortedList<Task>& Person::getTasks() const {
+const TaskQueue& Person::getTasks() const {
     return m_tasks;
 }
 
 void Person::setTasks(const SortedList<Task>& tasks) {
-    m_tasks = tasks;
+    m_tasks = TaskQueue(tasks.begin(), tasks.end());
 }
 
 // Other methods
-void Person::assignTask(const Task& task) {
-    m_tasks.insert(task);
+TaskQueue::ConstIterator Person::assignTask(const Task& task) {
+    return m_tasks.insert(task);
 }
 
+TaskQueue::ConstIterator Person::assignTask(Task&& task) {
+    return m_tasks.insert(std::move(task));
+}
+
+void Person::bumpTaskPriorities(TaskType type, int amount) {
+    m_tasks.update_if([type](const Task& task) {
+        return task.getType() == type;
+    }, [amount](Task& task) {
+        task.setPriority(task.getPriority() + amount);
+    });
+}
+
+void Person::bumpTaskPriorities(const std::vector<TaskQueue::ConstIterator>& tasks, int amount) {
+    m_tasks.update(tasks.begin(), tasks.end(), [amount](Task& task) {
+        task.setPriority(task.getPriority() + amount);
+    });
+}
+
+void Person::setTaskPriority(const TaskQueue::ConstIterator& task, int priority) {
+    m_tasks.update(task, [priority](Task& toChange) {
+        toChange.setPriority(priority);
+    });
+}
+
+void Person::removeTask(const TaskQueue::ConstIterator& task) {
+    m_tasks.remove(task);
+}
 
 int Person::completeTask() {
     if (m_tasks.length() == 0) {
@@ -43,7 +70,6 @@ const Task& Person::getHighestPriorityTask() const {
 // Overloaded operators
 ostream& operator<<(ostream& os, const Person& person) {
     os << "Person: " << person.m_name << endl;
-    // Assuming the SortedList has an appropriate method to list tasks
     for (const Task& t: person.m_tasks) {
         os << t << endl;
     }
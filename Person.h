@@ -3,8 +3,10 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include "Task.h"
 #include "SortedList.h"
+#include "TaskQueue.h"
 
 using mtm::SortedList;
 using std::ostream;
@@ -16,7 +18,7 @@ using std::string;
 class Person {
 private:
     string m_name;
-    SortedList<Task> m_tasks;
+    TaskQueue m_tasks;
 
 public:
     /**
@@ -29,20 +31,23 @@ public:
     /**
      * @brief Gets the name of the person.
      *
-     * @return string The name of the person.
+     * @return const string& The name of the person.
      */
-    string getName() const;
+    const string& getName() const;
 
     /**
      * @brief Gets the list of tasks assigned to the person.
      *
-     * @return const SortedList<Task>& The list of tasks assigned to the person.
+     * @return const TaskQueue& The tasks assigned to the person, highest priority first.
      */
-    const SortedList<Task>& getTasks() const;
+    const TaskQueue& getTasks() const;
 
     /**
      * @brief Sets the list of tasks for the person.
      *
+     * Every iterator into the old tasks is invalidated, so this must not be used on a
+     * Person owned by a TaskManager, whose indexes hold such iterators.
+     *
      * @param tasks The list of tasks to be set.
      */
     void setTasks(const SortedList<Task>& tasks);
@@ -51,8 +56,48 @@ public:
      * @brief Assigns a new task to the person.
      *
      * @param task The task to be assigned.
+     * @return TaskQueue::ConstIterator The position of the assigned task.
+     */
+    TaskQueue::ConstIterator assignTask(const Task& task);
+
+    /**
+     * @brief Assigns a new task to the person, moving it into the list.
+     *
+     * @param task The task to be assigned.
+     * @return TaskQueue::ConstIterator The position of the assigned task.
+     */
+    TaskQueue::ConstIterator assignTask(Task&& task);
+
+    /**
+     * @brief Raises the priority of all tasks of a specific type in place.
+     *
+     * @param type The type of tasks whose priority will be bumped.
+     * @param amount The amount by which the priority will be increased.
+     */
+    void bumpTaskPriorities(TaskType type, int amount);
+
+    /**
+     * @brief Raises the priority of several tasks in place.
+     *
+     * @param tasks The positions of distinct tasks, as returned by assignTask, best in list order.
+     * @param amount The amount by which the priority will be increased.
+     */
+    void bumpTaskPriorities(const std::vector<TaskQueue::ConstIterator>& tasks, int amount);
+
+    /**
+     * @brief Sets the priority of a single task in place.
+     *
+     * @param task The position of the task, as returned by assignTask.
+     * @param priority The new priority, enforced to be in range [0, 100].
+     */
+    void setTaskPriority(const TaskQueue::ConstIterator& task, int priority);
+
+    /**
+     * @brief Removes a single task from the list of tasks.
+     *
+     * @param task The position of the task, as returned by assignTask.
      */
-    void assignTask(const Task& task);
+    void removeTask(const TaskQueue::ConstIterator& task);
 
     /**
      * @brief Completes the highest priority task from the list of tasks.
@@ -0,0 +1,62 @@
+#include "PoolAllocator.h"
+
+namespace mtm {
+
+    namespace {
+        const std::size_t FIRST_SLAB_BLOCKS = 32;
+        const std::size_t MAX_SLAB_BLOCKS = 4096;
+    }
+
+    PoolResource::PoolResource() = default;
+
+    PoolResource::~PoolResource() {
+        for (void *slab : m_slabs) {
+            ::operator delete(slab);
+        }
+    }
+
+    void *PoolResource::allocate(std::size_t size) {
+        SizeClass &sizeClass = sizeClassFor(size);
+        if (sizeClass.m_free == nullptr) {
+            refill(sizeClass);
+        }
+        FreeBlock *block = sizeClass.m_free;
+        sizeClass.m_free = block->m_next;
+        return block;
+    }
+
+    void PoolResource::deallocate(void *block, std::size_t size) noexcept {
+        SizeClass &sizeClass = sizeClassFor(size);
+        auto *freed = static_cast<FreeBlock *>(block);
+        freed->m_next = sizeClass.m_free;
+        sizeClass.m_free = freed;
+    }
+
+    PoolResource::SizeClass &PoolResource::sizeClassFor(std::size_t size) {
+        const std::size_t alignment = alignof(std::max_align_t);
+        std::size_t blockSize = (size + alignment - 1) / alignment * alignment;
+        for (SizeClass &sizeClass : m_classes) {
+            if (sizeClass.m_blockSize == blockSize) {
+                return sizeClass;
+            }
+        }
+        m_classes.push_back(SizeClass{blockSize, FIRST_SLAB_BLOCKS, nullptr});
+        return m_classes.back();
+    }
+
+    // Slabs double in size up to MAX_SLAB_BLOCKS so short lists stay small.
+    void PoolResource::refill(SizeClass &sizeClass) {
+        m_slabs.reserve(m_slabs.size() + 1);
+        char *slab = static_cast<char *>(::operator new(sizeClass.m_blockSize * sizeClass.m_nextSlabBlocks));
+        m_slabs.push_back(slab);
+        for (std::size_t i = sizeClass.m_nextSlabBlocks; i > 0; --i) {
+            auto *block = reinterpret_cast<FreeBlock *>(slab + (i - 1) * sizeClass.m_blockSize);
+            block->m_next = sizeClass.m_free;
+            sizeClass.m_free = block;
+        }
+        if (sizeClass.m_nextSlabBlocks < MAX_SLAB_BLOCKS) {
+            sizeClass.m_nextSlabBlocks *= 2;
+        }
+    }
+
+} // namespace mtm
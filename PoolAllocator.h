@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * @brief Slab pool for fixed-size blocks.
+     *
+     * Blocks of each size class are carved out of large slabs and recycled through a
+     * free list, so steady-state allocation never reaches malloc. All slabs are released
+     * together when the pool is destroyed. A pool is not thread-safe and is meant to be
+     * owned by a single container.
+     */
+    class PoolResource {
+    public:
+        PoolResource();
+        ~PoolResource();
+
+        PoolResource(const PoolResource &other) = delete;
+        PoolResource &operator=(const PoolResource &other) = delete;
+
+        /**
+         * @brief Returns a block of at least size bytes, aligned for any scalar type.
+         */
+        void *allocate(std::size_t size);
+
+        /**
+         * @brief Returns a block obtained from allocate(size) to its free list.
+         */
+        void deallocate(void *block, std::size_t size) noexcept;
+
+    private:
+        struct FreeBlock {
+            FreeBlock *m_next;
+        };
+
+        struct SizeClass {
+            std::size_t m_blockSize;
+            std::size_t m_nextSlabBlocks;
+            FreeBlock *m_free;
+        };
+
+        std::vector<SizeClass> m_classes;
+        std::vector<void *> m_slabs;
+
+        SizeClass &sizeClassFor(std::size_t size);
+        void refill(SizeClass &sizeClass);
+    };
+
+    /**
+     * @brief std::allocator compatible front end for PoolResource.
+     *
+     * Single objects, such as list nodes, come from the pool; arrays go to operator new.
+     * Rebound copies share the pool, while a copied container gets a fresh one.
+     */
+    template<class T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        PoolAllocator();
+
+        template<class U>
+        PoolAllocator(const PoolAllocator<U> &other) noexcept;
+
+        T *allocate(std::size_t count);
+        void deallocate(T *pointer, std::size_t count) noexcept;
+
+        PoolAllocator select_on_container_copy_construction() const;
+
+        template<class U>
+        bool operator==(const PoolAllocator<U> &other) const noexcept;
+
+        template<class U>
+        bool operator!=(const PoolAllocator<U> &other) const noexcept;
+
+    private:
+        std::shared_ptr<PoolResource> m_resource;
+
+        template<class U>
+        friend class PoolAllocator;
+    };
+
+    template<class T>
+    PoolAllocator<T>::PoolAllocator() : m_resource(std::make_shared<PoolResource>()) {}
+
+    template<class T>
+    template<class U>
+    PoolAllocator<T>::PoolAllocator(const PoolAllocator<U> &other) noexcept : m_resource(other.m_resource) {}
+
+    template<class T>
+    T *PoolAllocator<T>::allocate(std::size_t count) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator does not support over-aligned types");
+        if (count == 1) {
+            return static_cast<T *>(m_resource->allocate(sizeof(T)));
+        }
+        return static_cast<T *>(::operator new(count * sizeof(T)));
+    }
+
+    template<class T>
+    void PoolAllocator<T>::deallocate(T *pointer, std::size_t count) noexcept {
+        if (count == 1) {
+            m_resource->deallocate(pointer, sizeof(T));
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    template<class T>
+    PoolAllocator<T> PoolAllocator<T>::select_on_container_copy_construction() const {
+        return PoolAllocator();
+    }
+
+    template<class T>
+    template<class U>
+    bool PoolAllocator<T>::operator==(const PoolAllocator<U> &other) const noexcept {
+        return m_resource == other.m_resource;
+    }
+
+    template<class T>
+    template<class U>
+    bool PoolAllocator<T>::operator!=(const PoolAllocator<U> &other) const noexcept {
+        return !(*this == other);
+    }
+
+} // namespace mtm
@@ -0,0 +1,254 @@
+#include "SnapshotReader.h"
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SNAPSHOT_READER_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace {
+
+    void checkRecord(bool condition) {
+        if (!condition) {
+            throw std::runtime_error("Snapshot is corrupt.");
+        }
+    }
+
+} // namespace
+
+SnapshotReader::SnapshotReader(const std::string &path) : m_data(nullptr), m_size(0), m_header(), m_layout() {
+#ifdef SNAPSHOT_READER_MMAP
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Cannot open snapshot file for reading.");
+    }
+    struct stat status;
+    if (::fstat(file, &status) != 0) {
+        ::close(file);
+        throw std::runtime_error("Cannot open snapshot file for reading.");
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size >= sizeof(SnapshotHeader)) {
+        void *mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(file);
+            throw std::runtime_error("Cannot map snapshot file.");
+        }
+        m_data = static_cast<const char *>(mapping);
+    }
+    ::close(file);
+#else
+    // without mmap the whole file is read up front
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Cannot open snapshot file for reading.");
+    }
+    m_size = static_cast<std::size_t>(in.tellg());
+    if (m_size >= sizeof(SnapshotHeader)) {
+        char *buffer = new char[m_size];
+        in.seekg(0);
+        if (!in.read(buffer, static_cast<std::streamsize>(m_size))) {
+            delete[] buffer;
+            throw std::runtime_error("Cannot read snapshot file.");
+        }
+        m_data = buffer;
+    }
+#endif
+    if (m_data == nullptr) {
+        throw std::runtime_error("Snapshot is truncated.");
+    }
+
+    // only the header and the small tables in front of the big sections are checked here
+    try {
+        m_header = load<SnapshotHeader>(0);
+        checkSnapshotHeader(m_header);
+        m_layout = getSnapshotLayout(m_header);
+        if (m_layout.m_end > m_size) {
+            throw std::runtime_error("Snapshot is truncated.");
+        }
+        std::uint64_t indexed = 0;
+        for (std::uint32_t type = 0; type < m_header.m_typeCount; ++type) {
+            std::uint64_t count = load<std::uint64_t>(m_layout.m_typeCounts + type * sizeof(std::uint64_t));
+            checkRecord(count <= m_header.m_taskCount - indexed);
+            indexed += count;
+        }
+        checkRecord(indexed == m_header.m_taskCount);
+        checkRecord(load<std::uint64_t>(m_layout.m_stringOffsets) == 0);
+        checkRecord(load<std::uint64_t>(m_layout.m_strings - sizeof(std::uint64_t)) == m_header.m_stringBytes);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+SnapshotReader::~SnapshotReader() {
+    release();
+}
+
+void SnapshotReader::release() noexcept {
+#ifdef SNAPSHOT_READER_MMAP
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char *>(m_data), m_size);
+    }
+#else
+    delete[] m_data;
+#endif
+    m_data = nullptr;
+}
+
+// Records are copied out of the mapping, so their alignment in the file does not matter.
+template<class T>
+T SnapshotReader::load(std::uint64_t offset) const {
+    T value;
+    std::memcpy(&value, m_data + offset, sizeof(T));
+    return value;
+}
+
+int SnapshotReader::getNextTaskId() const {
+    return m_header.m_nextTaskId;
+}
+
+std::size_t SnapshotReader::getTaskCount() const {
+    return static_cast<std::size_t>(m_header.m_taskCount);
+}
+
+std::size_t SnapshotReader::getPersonCount() const {
+    return m_header.m_personCount;
+}
+
+std::string_view SnapshotReader::getPersonName(std::size_t person) const {
+    if (person >= m_header.m_personCount) {
+        throw std::out_of_range("No employee with this number.");
+    }
+    return stringAt(load<SnapshotPerson>(m_layout.m_persons + person * sizeof(SnapshotPerson)).m_name);
+}
+
+int SnapshotReader::findPerson(std::string_view name) const {
+    for (std::size_t person = 0; person < m_header.m_personCount; ++person) {
+        if (getPersonName(person) == name) {
+            return static_cast<int>(person);
+        }
+    }
+    return -1;
+}
+
+SnapshotReader::Range SnapshotReader::getTasks(std::size_t person) const {
+    if (person >= m_header.m_personCount) {
+        throw std::out_of_range("No employee with this number.");
+    }
+    SnapshotPerson record = load<SnapshotPerson>(m_layout.m_persons + person * sizeof(SnapshotPerson));
+    checkRecord(record.m_firstTask <= m_header.m_taskCount &&
+                record.m_taskCount <= m_header.m_taskCount - record.m_firstTask);
+    return Range(this, 0, record.m_firstTask, record.m_firstTask + record.m_taskCount);
+}
+
+SnapshotReader::Range SnapshotReader::getTasksByType(TaskType type) const {
+    std::uint32_t wanted = static_cast<std::uint32_t>(type);
+    if (wanted >= m_header.m_typeCount) {
+        return Range(this, m_layout.m_typeIndexes, 0, 0);
+    }
+    std::uint64_t first = 0;
+    for (std::uint32_t before = 0; before < wanted; ++before) {
+        first += load<std::uint64_t>(m_layout.m_typeCounts + before * sizeof(std::uint64_t));
+    }
+    std::uint64_t count = load<std::uint64_t>(m_layout.m_typeCounts + wanted * sizeof(std::uint64_t));
+    return Range(this, m_layout.m_typeIndexes, first, first + count);
+}
+
+SnapshotReader::TaskView SnapshotReader::taskAt(std::uint64_t record) const {
+    checkRecord(record < m_header.m_taskCount);
+    SnapshotTask task = load<SnapshotTask>(m_layout.m_tasks + record * sizeof(SnapshotTask));
+    checkRecord(task.m_priority <= 100 && task.m_type <= static_cast<std::uint8_t>(TaskType::General));
+    return TaskView(task, stringAt(task.m_description));
+}
+
+std::string_view SnapshotReader::stringAt(std::uint32_t index) const {
+    checkRecord(index < m_header.m_stringCount);
+    std::uint64_t first = load<std::uint64_t>(m_layout.m_stringOffsets + index * sizeof(std::uint64_t));
+    std::uint64_t last = load<std::uint64_t>(m_layout.m_stringOffsets + (index + 1) * sizeof(std::uint64_t));
+    checkRecord(first <= last && last <= m_header.m_stringBytes);
+    return std::string_view(m_data + m_layout.m_strings + first, static_cast<std::size_t>(last - first));
+}
+
+SnapshotReader::TaskView::TaskView(const SnapshotTask &record, std::string_view description) :
+        m_record(record), m_description(description) {}
+
+int SnapshotReader::TaskView::getId() const {
+    return m_record.m_id;
+}
+
+int SnapshotReader::TaskView::getPriority() const {
+    return m_record.m_priority;
+}
+
+TaskType SnapshotReader::TaskView::getType() const {
+    return static_cast<TaskType>(m_record.m_type);
+}
+
+std::string_view SnapshotReader::TaskView::getDescription() const {
+    return m_description;
+}
+
+std::ostream &operator<<(std::ostream &os, const SnapshotReader::TaskView &task) {
+    os << "Task ID: " << task.getId() << ", Priority: " << task.getPriority();
+    os << ", Type: " << taskTypeToString(task.getType()) << ", Description: " << task.getDescription();
+    return os;
+}
+
+SnapshotReader::ConstIterator::ConstIterator(const SnapshotReader *reader, std::uint64_t indexes,
+                                             std::uint64_t position, std::uint64_t end) :
+        m_reader(reader), m_indexes(indexes), m_position(position), m_end(end) {}
+
+SnapshotReader::TaskView SnapshotReader::ConstIterator::operator*() const {
+    if (m_position >= m_end) {
+        throw std::out_of_range("Iterator out of range");
+    }
+    if (m_indexes == 0) {
+        return m_reader->taskAt(m_position);
+    }
+    return m_reader->taskAt(m_reader->load<std::uint32_t>(m_indexes + m_position * sizeof(std::uint32_t)));
+}
+
+SnapshotReader::ConstIterator &SnapshotReader::ConstIterator::operator++() {
+    if (m_position >= m_end) {
+        throw std::out_of_range("Iterator out of range");
+    }
+    m_position++;
+    return *this;
+}
+
+SnapshotReader::ConstIterator SnapshotReader::ConstIterator::operator++(int) {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+}
+
+bool SnapshotReader::ConstIterator::operator==(const ConstIterator &other) const {
+    return m_reader == other.m_reader && m_indexes == other.m_indexes && m_position == other.m_position;
+}
+
+bool SnapshotReader::ConstIterator::operator!=(const ConstIterator &other) const {
+    return !(*this == other);
+}
+
+SnapshotReader::Range::Range(const SnapshotReader *reader, std::uint64_t indexes, std::uint64_t first,
+                             std::uint64_t last) :
+        m_reader(reader), m_indexes(indexes), m_first(first), m_last(last) {}
+
+SnapshotReader::ConstIterator SnapshotReader::Range::begin() const {
+    return ConstIterator(m_reader, m_indexes, m_first, m_last);
+}
+
+SnapshotReader::ConstIterator SnapshotReader::Range::end() const {
+    return ConstIterator(m_reader, m_indexes, m_last, m_last);
+}
+
+std::size_t SnapshotReader::Range::length() const {
+    return static_cast<std::size_t>(m_last - m_first);
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "Task.h"
+#include "TaskSnapshot.h"
+
+/**
+ * @brief Read-only view of a snapshot written by TaskManager::saveSnapshot.
+ *
+ * The file is mapped into memory and never copied or parsed as a whole: opening it only
+ * checks the header, the file size and the per-type counts, and tasks, names and
+ * descriptions are read from the mapped bytes when they are iterated, so opening is
+ * instant whatever the size and only the pages actually read are loaded. Records are
+ * checked as they are read, and a corrupt one throws std::runtime_error. The views and
+ * iterators stay valid as long as the reader.
+ */
+class SnapshotReader {
+public:
+    class TaskView;
+    class ConstIterator;
+    class Range;
+
+    /**
+     * @brief Maps a snapshot file.
+     *
+     * @param path The path of the snapshot.
+     * @throws std::runtime_error If the file cannot be mapped or is not a valid snapshot.
+     */
+    explicit SnapshotReader(const std::string &path);
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader &other) = delete;
+    SnapshotReader &operator=(const SnapshotReader &other) = delete;
+
+    /**
+     * @brief Gets the ID the saved manager would have given its next task.
+     */
+    int getNextTaskId() const;
+
+    /**
+     * @brief Gets the number of tasks in the snapshot.
+     */
+    std::size_t getTaskCount() const;
+
+    /**
+     * @brief Gets the number of employees in the snapshot.
+     */
+    std::size_t getPersonCount() const;
+
+    /**
+     * @brief Gets the name of an employee, pointing into the mapping.
+     *
+     * @param person The employee's number, in the order the employees were added.
+     * @throws std::out_of_range If person is not below getPersonCount().
+     */
+    std::string_view getPersonName(std::size_t person) const;
+
+    /**
+     * @brief Finds an employee by name with a scan of the employee records.
+     *
+     * @param name The name of the employee.
+     * @return int The employee's number, -1 if nobody has this name.
+     */
+    int findPerson(std::string_view name) const;
+
+    /**
+     * @brief Gets the tasks of an employee, in the order of their list.
+     *
+     * @param person The employee's number.
+     * @throws std::out_of_range If person is not below getPersonCount().
+     */
+    Range getTasks(std::size_t person) const;
+
+    /**
+     * @brief Gets the tasks of a type, in the order of TaskManager::printTasksByType.
+     *
+     * @param type The type of the tasks.
+     */
+    Range getTasksByType(TaskType type) const;
+
+private:
+    const char *m_data;
+    std::size_t m_size;
+    SnapshotHeader m_header;
+    SnapshotLayout m_layout;
+
+    void release() noexcept;
+    template<class T>
+    T load(std::uint64_t offset) const;
+    TaskView taskAt(std::uint64_t record) const;
+    std::string_view stringAt(std::uint32_t index) const;
+};
+
+/**
+ * @brief A task of a snapshot; the description points into the mapping.
+ */
+class SnapshotReader::TaskView {
+public:
+    int getId() const;
+    int getPriority() const;
+    TaskType getType() const;
+    std::string_view getDescription() const;
+
+    /**
+     * @brief Prints the task like operator<<(ostream &, const Task &).
+     */
+    friend std::ostream &operator<<(std::ostream &os, const TaskView &task);
+
+private:
+    SnapshotTask m_record;
+    std::string_view m_description;
+
+    TaskView(const SnapshotTask &record, std::string_view description);
+
+    friend class SnapshotReader;
+};
+
+/**
+ * @brief Iterator over the tasks of a Range, yielding TaskView values.
+ */
+class SnapshotReader::ConstIterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = TaskView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = TaskView;
+
+    TaskView operator*() const;
+    ConstIterator &operator++();
+    ConstIterator operator++(int);
+    bool operator==(const ConstIterator &other) const;
+    bool operator!=(const ConstIterator &other) const;
+
+private:
+    const SnapshotReader *m_reader;
+    std::uint64_t m_indexes; // Offset of the record indexes, 0 when the records are consecutive
+    std::uint64_t m_position;
+    std::uint64_t m_end;
+
+    ConstIterator(const SnapshotReader *reader, std::uint64_t indexes, std::uint64_t position, std::uint64_t end);
+
+    friend class SnapshotReader;
+};
+
+/**
+ * @brief Tasks of one employee or of one type.
+ */
+class SnapshotReader::Range {
+public:
+    ConstIterator begin() const;
+    ConstIterator end() const;
+    std::size_t length() const;
+
+private:
+    const SnapshotReader *m_reader;
+    std::uint64_t m_indexes;
+    std::uint64_t m_first;
+    std::uint64_t m_last;
+
+    Range(const SnapshotReader *reader, std::uint64_t indexes, std::uint64_t first, std::uint64_t last);
+
+    friend class SnapshotReader;
+};
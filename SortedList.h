@@ -1,17 +1,32 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
 
 namespace mtm {
 
+    template<class T>
+    class IndexNode;
+
     template<class T>
     class Node {
     public:
         T m_data;
         Node *m_next;
+        Node *m_prev;
+        IndexNode<T> *m_index;
 
         explicit Node(const T &data);
+        explicit Node(T &&data);
 
         Node(const Node &toCopy) = default;
         Node &operator=(const Node &node) = default;
@@ -28,7 +43,10 @@ namespace mtm {
     }
 
     template<class T>
-    Node<T>::Node(const T &data) : m_data(data), m_next(nullptr) {}
+    Node<T>::Node(const T &data) : m_data(data), m_next(nullptr), m_prev(nullptr), m_index(nullptr) {}
+
+    template<class T>
+    Node<T>::Node(T &&data) : m_data(std::move(data)), m_next(nullptr), m_prev(nullptr), m_index(nullptr) {}
 
     template<class T>
     Node<T> *Node<T>::nodeGetNext() const {
@@ -40,7 +58,130 @@ namespace mtm {
         return this->m_data;
     }
 
+    /**
+     * Express-lane entry of the skip list index kept on top of the node chain.
+     * Level 0 entries point at data nodes directly, higher levels go down to the
+     * entry of the same node one level below. Levels are doubly linked and every
+     * node knows its level 0 entry, so a node can be unlinked without a search.
+     */
     template<class T>
+    class IndexNode {
+    public:
+        Node<T> *m_node;
+        IndexNode *m_right;
+        IndexNode *m_left;
+        IndexNode *m_down;
+        IndexNode *m_up;
+
+        IndexNode(Node<T> *node, IndexNode *left, IndexNode *down);
+    };
+
+    template<class T>
+    IndexNode<T>::IndexNode(Node<T> *node, IndexNode *left, IndexNode *down) :
+            m_node(node), m_right(nullptr), m_left(left), m_down(down), m_up(nullptr) {}
+
+    /**
+     * Default ordering of SortedList: lhs goes in front of rhs when lhs > rhs.
+     */
+    template<class T>
+    struct Greater {
+        constexpr bool operator()(const T &lhs, const T &rhs) const {
+            return lhs > rhs;
+        }
+    };
+
+    /**
+     * Orders elements by a key taken from them with KeyOf, larger keys first. With an
+     * inline KeyOf that returns an integer, every comparison compiles down to a load
+     * and a compare, with no call into the element type.
+     */
+    template<class KeyOf>
+    struct KeyGreater {
+        template<class T>
+        constexpr bool operator()(const T &lhs, const T &rhs) const {
+            return KeyOf()(lhs) > KeyOf()(rhs);
+        }
+    };
+
+    template<class Source, class Condition>
+    class FilteredView;
+
+    template<class Source, class Operation>
+    class TransformedView;
+
+    /*
+     * What a view needs to know about its source: the list at the root of the chain,
+     * whether the source is still in the order of that list, and how to hold on to it.
+     * A list is held by pointer and must outlive its views; a view is small and is held
+     * by value, so chained views can be stored in a variable.
+     */
+    template<class Source>
+    struct ViewTraits {
+        using List = Source;
+        using Storage = const Source *;
+        static constexpr bool IN_LIST_ORDER = true;
+
+        static Storage store(const Source &source) {
+            return &source;
+        }
+
+        static const Source &get(const Storage &storage) {
+            return *storage;
+        }
+    };
+
+    template<class Source, class Condition>
+    struct ViewTraits<FilteredView<Source, Condition>> {
+        using List = typename ViewTraits<Source>::List;
+        using Storage = FilteredView<Source, Condition>;
+        static constexpr bool IN_LIST_ORDER = ViewTraits<Source>::IN_LIST_ORDER;
+
+        static Storage store(const Storage &source) {
+            return source;
+        }
+
+        static const Storage &get(const Storage &storage) {
+            return storage;
+        }
+    };
+
+    template<class Source, class Operation>
+    struct ViewTraits<TransformedView<Source, Operation>> {
+        using List = typename ViewTraits<Source>::List;
+        using Storage = TransformedView<Source, Operation>;
+        static constexpr bool IN_LIST_ORDER = false;
+
+        static Storage store(const Storage &source) {
+            return source;
+        }
+
+        static const Storage &get(const Storage &storage) {
+            return storage;
+        }
+    };
+
+    /**
+     * How the parallel overloads of filter and apply split their work: lists shorter
+     * than m_threshold, or a pool of one thread, take the sequential path. A null pool
+     * means ThreadPool::shared().
+     */
+    struct ParallelPolicy {
+        int m_threshold;
+        ThreadPool *m_pool;
+
+        explicit ParallelPolicy(int threshold = 100000, ThreadPool *pool = nullptr) :
+                m_threshold(threshold), m_pool(pool) {}
+
+        ThreadPool &pool() const {
+            return (m_pool == nullptr) ? ThreadPool::shared() : *m_pool;
+        }
+    };
+
+    /*
+     * Compare is a strict weak ordering where compare(a, b) means that a goes in front of
+     * b. Equal elements (neither goes in front) keep the order described for every operation.
+     */
+    template<class T, class Compare = Greater<T>, class Alloc = std::allocator<T>>
     class SortedList {
     public:
         class ConstIterator;
@@ -49,43 +190,447 @@ namespace mtm {
         ConstIterator end() const;
 
         SortedList();
+        explicit SortedList(const Alloc &allocator);
+        explicit SortedList(const Compare &compare, const Alloc &allocator = Alloc());
+
+        template<class InputIterator>
+        SortedList(InputIterator first, InputIterator last, const Alloc &allocator = Alloc());
+
+        template<class InputIterator>
+        SortedList(InputIterator first, InputIterator last, const Compare &compare,
+                   const Alloc &allocator = Alloc());
+
         SortedList(const SortedList &other);
+        SortedList(SortedList &&other) noexcept;
         SortedList &operator=(const SortedList &other);
+        SortedList &operator=(SortedList &&other)
+                noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                         std::allocator_traits<Alloc>::is_always_equal::value);
         ~SortedList();
 
-        void insert(const T &insert_value);
-        void remove(const SortedList<T>::ConstIterator &iterator);
+        ConstIterator insert(const T &insert_value);
+        ConstIterator insert(T &&insert_value);
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last);
+
+        void merge(SortedList &other);
+
+        template<class ListIterator>
+        void merge(ListIterator first, ListIterator last);
+
+        void remove(const SortedList<T, Compare, Alloc>::ConstIterator &iterator);
+
+        template<class Condition>
+        int erase_if(Condition condition);
+
+        template<class Condition, class Operation>
+        int update_if(Condition condition, Operation operation);
+
+        template<class Operation>
+        void update(const ConstIterator &iterator, Operation operation);
+
+        ConstIterator find(const T &value) const;
+
         int length() const;
 
+        Alloc get_allocator() const;
+
+        template<class Condition>
+        SortedList<T, Compare, Alloc> filter(Condition condition) const;
+
+        template<class Operation>
+        SortedList<T, Compare, Alloc> apply(Operation operation) const;
+
+        template<class Condition>
+        SortedList<T, Compare, Alloc> filter(Condition condition, const ParallelPolicy &policy) const;
+
+        template<class Operation>
+        SortedList<T, Compare, Alloc> apply(Operation operation, const ParallelPolicy &policy) const;
+
         template<class Condition>
-        SortedList<T> filter(Condition condition) const;
+        FilteredView<SortedList, Condition> filtered(Condition condition) const;
 
         template<class Operation>
-        SortedList<T> apply(Operation operation) const;
+        TransformedView<SortedList, Operation> transformed(Operation operation) const;
 
         bool operator==(const SortedList &other);
 
     private:
+        template<class Source, class Condition>
+        friend class FilteredView;
+
+        // Nodes linked in list order that do not belong to any list yet.
+        struct Chain {
+            Node<T> *m_first;
+            Node<T> *m_last;
+            int m_length;
+        };
+
+        // std::allocator may be used from several threads at once, so workers create nodes themselves
+        static constexpr bool PARALLEL_ALLOCATION = std::is_same<Alloc, std::allocator<T>>::value;
+        static const unsigned int CHUNKS_PER_THREAD = 4;
+
+        template<class Source, class Operation>
+        friend class TransformedView;
+
+        static const int MAX_LEVEL = 16;
+
+        using AllocTraits = std::allocator_traits<Alloc>;
+        using NodeAllocator = typename AllocTraits::template rebind_alloc<Node<T>>;
+        using NodeTraits = std::allocator_traits<NodeAllocator>;
+        using IndexAllocator = typename AllocTraits::template rebind_alloc<IndexNode<T>>;
+        using IndexTraits = std::allocator_traits<IndexAllocator>;
+
+        NodeAllocator m_nodeAllocator;
+        IndexAllocator m_indexAllocator;
+        Compare m_compare;
+
         Node<T> *m_head;
         Node<T> *m_end;
         int m_length;
+        IndexNode<T> *m_index[MAX_LEVEL];
+        int m_levels;
+        unsigned int m_seed;
+
+        Node<T> *createNode(const T &value);
+        Node<T> *createNode(T &&value);
+        void destroyNode(Node<T> *node);
+        IndexNode<T> *createIndexNode(Node<T> *node, IndexNode<T> *left, IndexNode<T> *down);
+        void destroyIndexNode(IndexNode<T> *entry);
 
         void deleteAllNodes();
+        void deleteIndex();
+        void rebuildIndex() noexcept;
+        void destroyTower(Node<T> *node) noexcept;
+        void attachNode(Node<T> *node) noexcept;
+        ConstIterator insertNode(Node<T> *new_node);
+        void detachNode(Node<T> *node) noexcept;
+        void attachAll(Node<T> *stack) noexcept;
+        void unlinkNode(Node<T> *node) noexcept;
+        void spliceSorted(Node<T> *chain, int count) noexcept;
+        void pushBack(const T &value);
+        void insertValues(std::vector<T> &values);
+        SortedList emptyCopy() const;
+        std::vector<Node<T> *> chunkStarts(std::size_t chunks) const;
+        static void linkToChain(Chain &chain, Node<T> *node) noexcept;
+        void destroyChain(Chain &chain) noexcept;
+        void adoptChains(std::vector<Chain> &chains) noexcept;
+        void appendAll(const SortedList &other);
+        void swapContents(SortedList &other) noexcept;
+        void releaseNodes() noexcept;
+        int randomLevel();
+        Node<T> *findPredecessor(const T &value, IndexNode<T> **update) const;
     };
 
-    template<class T>
-    void SortedList<T>::deleteAllNodes() {
+    template<class T, class Compare, class Alloc>
+    Node<T> *SortedList<T, Compare, Alloc>::createNode(const T &value) {
+        Node<T> *node = NodeTraits::allocate(m_nodeAllocator, 1);
+        try {
+            NodeTraits::construct(m_nodeAllocator, node, value);
+        } catch (...) {
+            NodeTraits::deallocate(m_nodeAllocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    template<class T, class Compare, class Alloc>
+    Node<T> *SortedList<T, Compare, Alloc>::createNode(T &&value) {
+        Node<T> *node = NodeTraits::allocate(m_nodeAllocator, 1);
+        try {
+            NodeTraits::construct(m_nodeAllocator, node, std::move(value));
+        } catch (...) {
+            NodeTraits::deallocate(m_nodeAllocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::destroyNode(Node<T> *node) {
+        NodeTraits::destroy(m_nodeAllocator, node);
+        NodeTraits::deallocate(m_nodeAllocator, node, 1);
+    }
+
+    template<class T, class Compare, class Alloc>
+    IndexNode<T> *SortedList<T, Compare, Alloc>::createIndexNode(Node<T> *node, IndexNode<T> *left, IndexNode<T> *down) {
+        IndexNode<T> *entry = IndexTraits::allocate(m_indexAllocator, 1);
+        IndexTraits::construct(m_indexAllocator, entry, node, left, down);
+        return entry;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::destroyIndexNode(IndexNode<T> *entry) {
+        IndexTraits::destroy(m_indexAllocator, entry);
+        IndexTraits::deallocate(m_indexAllocator, entry, 1);
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::deleteIndex() {
+        for (IndexNode<T> *entry = m_index[0]; entry != nullptr; entry = entry->m_right) {
+            entry->m_node->m_index = nullptr;
+        }
+        for (int level = 0; level < m_levels; ++level) {
+            while (m_index[level] != nullptr) {
+                IndexNode<T> *toDelete = m_index[level];
+                m_index[level] = toDelete->m_right;
+                destroyIndexNode(toDelete);
+            }
+        }
+        m_levels = 0;
+    }
+
+    /*
+     * Builds a perfectly balanced index over the current chain in one pass: every
+     * fourth node gets a level 0 entry, every sixteenth a level 1 entry and so on.
+     * If an entry cannot be allocated the index built so far is kept; it is still
+     * valid, searches just walk further on the chain.
+     */
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::rebuildIndex() noexcept {
+        deleteIndex();
+        IndexNode<T> *tails[MAX_LEVEL];
+        unsigned int position = 0;
+        try {
+            for (Node<T> *current = m_head; current != nullptr; current = current->m_next) {
+                position++;
+                IndexNode<T> *down = nullptr;
+                for (int level = 0; level < MAX_LEVEL - 1 && position % (4u << (2 * level)) == 0; ++level) {
+                    auto *entry = createIndexNode(current, level < m_levels ? tails[level] : nullptr, down);
+                    if (level >= m_levels) {
+                        m_index[level] = entry;
+                        m_levels = level + 1;
+                    } else {
+                        tails[level]->m_right = entry;
+                    }
+                    if (down == nullptr) {
+                        current->m_index = entry;
+                    } else {
+                        down->m_up = entry;
+                    }
+                    tails[level] = entry;
+                    down = entry;
+                }
+            }
+        } catch (...) {
+        }
+    }
+
+    /*
+     * Links a sorted chain of count detached nodes into the list in one pass. A node
+     * from the chain goes in front of existing elements that compare equal to it,
+     * just like insert. The index is rebuilt afterwards.
+     */
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::spliceSorted(Node<T> *chain, int count) noexcept {
+        Node<T> *previous = nullptr;
+        Node<T> *existing = m_head;
+        while (chain != nullptr) {
+            while (existing != nullptr && m_compare(existing->m_data, chain->m_data)) {
+                previous = existing;
+                existing = existing->m_next;
+            }
+            Node<T> *next = chain->m_next;
+            chain->m_next = existing;
+            chain->m_prev = previous;
+            if (previous == nullptr) {
+                m_head = chain;
+            } else {
+                previous->m_next = chain;
+            }
+            if (existing == nullptr) {
+                m_end = chain;
+            } else {
+                existing->m_prev = chain;
+            }
+            previous = chain;
+            chain = next;
+        }
+        m_length += count;
+        rebuildIndex();
+    }
+
+    // Links a copy of value after m_end without touching the index.
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::pushBack(const T &value) {
+        auto *new_node = createNode(value);
+        new_node->m_prev = m_end;
+        if (m_end == nullptr) {
+            m_head = new_node;
+        } else {
+            m_end->m_next = new_node;
+        }
+        m_end = new_node;
+        m_length++;
+    }
+
+    // An empty list with the same ordering, and the allocator a copy of this list would get.
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc> SortedList<T, Compare, Alloc>::emptyCopy() const {
+        return SortedList(m_compare, AllocTraits::select_on_container_copy_construction(Alloc(m_nodeAllocator)));
+    }
+
+    /*
+     * Cuts the list into at most chunks runs of similar length and returns the first
+     * node of every run. The cuts are taken from the sparsest index level that has
+     * enough entries, so the nodes themselves are not walked.
+     */
+    template<class T, class Compare, class Alloc>
+    std::vector<Node<T> *> SortedList<T, Compare, Alloc>::chunkStarts(std::size_t chunks) const {
+        std::vector<Node<T> *> starts;
+        if (m_head == nullptr) {
+            return starts;
+        }
+        starts.push_back(m_head);
+        std::vector<Node<T> *> cuts;
+        for (int level = m_levels - 1; level >= 0; --level) {
+            cuts.clear();
+            for (IndexNode<T> *entry = m_index[level]; entry != nullptr; entry = entry->m_right) {
+                cuts.push_back(entry->m_node);
+            }
+            if (cuts.size() >= chunks) {
+                break;
+            }
+        }
+        for (std::size_t i = 1; i < chunks && !cuts.empty(); ++i) {
+            Node<T> *cut = cuts[i * cuts.size() / chunks];
+            if (cut != starts.back()) {
+                starts.push_back(cut);
+            }
+        }
+        return starts;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::linkToChain(Chain &chain, Node<T> *node) noexcept {
+        node->m_prev = chain.m_last;
+        if (chain.m_last == nullptr) {
+            chain.m_first = node;
+        } else {
+            chain.m_last->m_next = node;
+        }
+        chain.m_last = node;
+        chain.m_length++;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::destroyChain(Chain &chain) noexcept {
+        while (chain.m_first != nullptr) {
+            Node<T> *next = chain.m_first->m_next;
+            destroyNode(chain.m_first);
+            chain.m_first = next;
+        }
+        chain = Chain{nullptr, nullptr, 0};
+    }
+
+    // Appends the chains, in order, to the end of the list and indexes the result.
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::adoptChains(std::vector<Chain> &chains) noexcept {
+        for (Chain &chain : chains) {
+            if (chain.m_first == nullptr) {
+                continue;
+            }
+            chain.m_first->m_prev = m_end;
+            if (m_end == nullptr) {
+                m_head = chain.m_first;
+            } else {
+                m_end->m_next = chain.m_first;
+            }
+            m_end = chain.m_last;
+            m_length += chain.m_length;
+            chain = Chain{nullptr, nullptr, 0};
+        }
+        rebuildIndex();
+    }
+
+    // Appends a copy of every element of other in its order; other must be sorted after this list.
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::appendAll(const SortedList &other) {
+        for (Node<T> *current = other.m_head; current != nullptr; current = current->m_next) {
+            pushBack(current->nodeGetData());
+        }
+        rebuildIndex();
+    }
+
+    // Forgets the chain after its nodes were handed over to another list.
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::releaseNodes() noexcept {
+        deleteIndex();
+        m_head = nullptr;
+        m_end = nullptr;
+        m_length = 0;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::swapContents(SortedList &other) noexcept {
+        std::swap(m_head, other.m_head);
+        std::swap(m_end, other.m_end);
+        std::swap(m_length, other.m_length);
+        std::swap(m_index, other.m_index);
+        std::swap(m_levels, other.m_levels);
+        std::swap(m_seed, other.m_seed);
+        std::swap(m_compare, other.m_compare);
+    }
+
+    // Every index level holds about a quarter of the entries of the level below.
+    template<class T, class Compare, class Alloc>
+    int SortedList<T, Compare, Alloc>::randomLevel() {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        unsigned int bits = m_seed;
+        int level = 0;
+        while ((bits & 3u) == 0 && level <= m_levels && level < MAX_LEVEL - 1) {
+            ++level;
+            bits >>= 2;
+        }
+        return level;
+    }
+
+    /*
+     * Finds the last node that must stay in front of value, or nullptr if value
+     * belongs at the head. update[level] receives the last index entry of every
+     * level that is in front of value (nullptr when there is none).
+     */
+    template<class T, class Compare, class Alloc>
+    Node<T> *SortedList<T, Compare, Alloc>::findPredecessor(const T &value, IndexNode<T> **update) const {
+        IndexNode<T> *current = nullptr;
+        for (int level = m_levels - 1; level >= 0; --level) {
+            IndexNode<T> *next = (current == nullptr) ? m_index[level] : current->m_right;
+            while (next != nullptr && m_compare(next->m_node->m_data, value)) {
+                current = next;
+                next = current->m_right;
+            }
+            update[level] = current;
+            if (current != nullptr && level > 0) {
+                current = current->m_down;
+            }
+        }
+
+        Node<T> *previous = (current == nullptr) ? nullptr : current->m_node;
+        Node<T> *next = (previous == nullptr) ? m_head : previous->m_next;
+        while (next != nullptr && m_compare(next->m_data, value)) {
+            previous = next;
+            next = next->m_next;
+        }
+        return previous;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::deleteAllNodes() {
+        deleteIndex();
         while (m_head != nullptr) {
             Node<T> *toDelete = m_head;
             m_head = m_head->m_next;
-            delete toDelete;
+            destroyNode(toDelete);
         }
         m_end = nullptr;
         m_length = 0;
     }
 
-    template<class T>
-    bool SortedList<T>::operator==(const SortedList<T> &other) {
+    template<class T, class Compare, class Alloc>
+    bool SortedList<T, Compare, Alloc>::operator==(const SortedList<T, Compare, Alloc> &other) {
         if (m_length != other.m_length)
             return false;
 
@@ -101,128 +646,550 @@ namespace mtm {
         return true;
     }
 
-    template<class T>
-    SortedList<T>::SortedList() : m_head(nullptr), m_end(nullptr), m_length(0) {}
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc>::SortedList() : SortedList(Compare(), Alloc()) {}
 
-    template<class T>
-    SortedList<T>::SortedList(const SortedList &other) : m_head(nullptr), m_end(nullptr), m_length(0) {
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc>::SortedList(const Alloc &allocator) : SortedList(Compare(), allocator) {}
+
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc>::SortedList(const Compare &compare, const Alloc &allocator) :
+            m_nodeAllocator(allocator), m_indexAllocator(allocator), m_compare(compare), m_head(nullptr),
+            m_end(nullptr), m_length(0), m_index(), m_levels(0), m_seed(2463534242u) {}
+
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc>::SortedList(const SortedList &other) :
+            SortedList(other.m_compare,
+                       AllocTraits::select_on_container_copy_construction(Alloc(other.m_nodeAllocator))) {
         try {
-            Node<T> *current = other.m_head;
-            while (current != nullptr) {
-                insert(current->nodeGetData());
-                current = current->m_next;
-            }
+            appendAll(other);
         } catch (...) {
             deleteAllNodes();
             throw;
         }
     }
 
-    template<class T>
-    SortedList<T> &SortedList<T>::operator=(const SortedList<T> &other) {
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc>::SortedList(SortedList &&other) noexcept :
+            SortedList(other.m_compare, Alloc(other.m_nodeAllocator)) {
+        swapContents(other);
+    }
+
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc> &SortedList<T, Compare, Alloc>::operator=(const SortedList<T, Compare, Alloc> &other) {
         if (this == &other) {
             return *this;
         }
 
-        SortedList<T> temp;
-        try {
-            Node<T> *current = other.m_head;
-            while (current != nullptr) {
-                temp.insert(current->nodeGetData());
-                current = current->m_next;
-            }
-        } catch (...) {
-            temp.deleteAllNodes();
-            throw;
+        Alloc allocator = AllocTraits::propagate_on_container_copy_assignment::value ?
+                          Alloc(other.m_nodeAllocator) : Alloc(m_nodeAllocator);
+        SortedList<T, Compare, Alloc> temp(other.m_compare, allocator);
+        temp.appendAll(other);
+        deleteAllNodes();
+        m_nodeAllocator = temp.m_nodeAllocator;
+        m_indexAllocator = temp.m_indexAllocator;
+        swapContents(temp);
+        return *this;
+    }
+
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc> &SortedList<T, Compare, Alloc>::operator=(SortedList<T, Compare, Alloc> &&other)
+            noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                     std::allocator_traits<Alloc>::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        // nodes owned by an unrelated allocator cannot be adopted, only copied
+        if (!AllocTraits::propagate_on_container_move_assignment::value &&
+            !(m_nodeAllocator == other.m_nodeAllocator)) {
+            return *this = static_cast<const SortedList &>(other);
         }
 
         deleteAllNodes();
+        if (AllocTraits::propagate_on_container_move_assignment::value) {
+            m_nodeAllocator = other.m_nodeAllocator;
+            m_indexAllocator = other.m_indexAllocator;
+        }
+        swapContents(other);
+        return *this;
+    }
 
-        m_head = temp.m_head;
-        m_end = temp.m_end;
-        m_length = temp.m_length;
-
-        temp.m_head = nullptr;
-        temp.m_end = nullptr;
-        temp.m_length = 0;
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    SortedList<T, Compare, Alloc>::SortedList(InputIterator first, InputIterator last, const Alloc &allocator) :
+            SortedList(first, last, Compare(), allocator) {}
 
-        return *this;
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    SortedList<T, Compare, Alloc>::SortedList(InputIterator first, InputIterator last, const Compare &compare,
+                                              const Alloc &allocator) :
+            SortedList(compare, allocator) {
+        insert(first, last);
     }
 
-    template<class T>
-    SortedList<T>::~SortedList() {
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc>::~SortedList() {
         deleteAllNodes();
     }
 
-    template<class T>
-    void SortedList<T>::insert(const T &insert_value) {
-        auto *new_node = new Node<T>(insert_value);
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator SortedList<T, Compare, Alloc>::insert(const T &insert_value) {
+        return insertNode(createNode(insert_value));
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator SortedList<T, Compare, Alloc>::insert(T &&insert_value) {
+        return insertNode(createNode(std::move(insert_value)));
+    }
+
+    /* Builds the index tower of a fresh node and links it; the node is freed on failure. */
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator SortedList<T, Compare, Alloc>::insertNode(Node<T> *new_node) {
+        IndexNode<T> *below = nullptr;
         try {
-            if (m_head == nullptr || !(m_head->m_data > insert_value)) {
-                new_node->m_next = m_head;
-                m_head = new_node;
-                if (m_end == nullptr) {
-                    m_end = new_node;
+            int height = randomLevel();
+            for (int level = 0; level < height; ++level) {
+                IndexNode<T> *entry = createIndexNode(new_node, nullptr, below);
+                if (below == nullptr) {
+                    new_node->m_index = entry;
+                } else {
+                    below->m_up = entry;
                 }
+                below = entry;
+            }
+        } catch (...) {
+            destroyTower(new_node);
+            destroyNode(new_node);
+            throw;
+        }
+        attachNode(new_node);
+        return ConstIterator(this, new_node);
+    }
+
+    /*
+     * Sorts the range once and merges it into the list in a single pass, giving the
+     * same order as inserting the elements one by one in range order. A range that
+     * is already in list order, or in exactly the opposite order, is not sorted
+     * again. If an exception is thrown the list is left unchanged.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    void SortedList<T, Compare, Alloc>::insert(InputIterator first, InputIterator last) {
+        std::vector<T> values(first, last);
+        insertValues(values);
+    }
+
+    // Bulk insert of values in range order; their elements are moved from.
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::insertValues(std::vector<T> &values) {
+        if (values.empty()) {
+            return;
+        }
+
+        bool inListOrder = true;
+        bool inReverseOrder = true;
+        for (std::size_t i = 1; i < values.size(); ++i) {
+            if (m_compare(values[i - 1], values[i])) {
+                inReverseOrder = false;
             } else {
-                Node<T> *current = m_head;
-                while (current->m_next != nullptr && (current->m_next->m_data > insert_value)) {
-                    current = current->m_next;
+                inListOrder = false;
+            }
+        }
+        // one-by-one insertion puts later elements in front of equal ones, hence the reverse
+        if (!inListOrder) {
+            std::reverse(values.begin(), values.end());
+            if (!inReverseOrder) {
+                std::stable_sort(values.begin(), values.end(), m_compare);
+            }
+        }
+
+        Node<T> *chain = nullptr;
+        Node<T> *chainEnd = nullptr;
+        try {
+            for (T &value : values) {
+                Node<T> *new_node = createNode(std::move(value));
+                if (chainEnd == nullptr) {
+                    chain = new_node;
+                } else {
+                    chainEnd->m_next = new_node;
                 }
-                new_node->m_next = current->m_next;
-                current->m_next = new_node;
-                if (new_node->m_next == nullptr) {
-                    m_end = new_node;
+                chainEnd = new_node;
+            }
+        } catch (...) {
+            while (chain != nullptr) {
+                Node<T> *toDelete = chain;
+                chain = chain->m_next;
+                destroyNode(toDelete);
+            }
+            throw;
+        }
+        spliceSorted(chain, static_cast<int>(values.size()));
+    }
+
+    /*
+     * Moves every node of other into this list in a single pass, without copying any
+     * element, and leaves other empty. Among equal elements those already in this
+     * list come first. Lists whose allocators differ are merged through a copy.
+     */
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::merge(SortedList &other) {
+        if (this == &other || other.m_head == nullptr) {
+            return;
+        }
+        if (!(m_nodeAllocator == other.m_nodeAllocator)) {
+            SortedList<T, Compare, Alloc> adopted(m_compare, Alloc(m_nodeAllocator));
+            adopted.appendAll(other);
+            merge(adopted);
+            other.deleteAllNodes();
+            return;
+        }
+
+        Node<T> *mine = m_head;
+        Node<T> *theirs = other.m_head;
+        Node<T> *last = nullptr;
+        while (mine != nullptr || theirs != nullptr) {
+            Node<T> *next;
+            if (mine == nullptr || (theirs != nullptr && m_compare(theirs->m_data, mine->m_data))) {
+                next = theirs;
+                theirs = theirs->m_next;
+            } else {
+                next = mine;
+                mine = mine->m_next;
+            }
+            if (last == nullptr) {
+                m_head = next;
+            } else {
+                last->m_next = next;
+            }
+            next->m_prev = last;
+            last = next;
+        }
+        m_end = last;
+        m_length += other.m_length;
+        other.releaseNodes();
+        rebuildIndex();
+    }
+
+    /*
+     * k-way version of merge: moves the nodes of every list in [first, last) into this
+     * list using a heap over the current heads, in O(total log k). Among equal elements
+     * this list comes first, then the others in range order.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class ListIterator>
+    void SortedList<T, Compare, Alloc>::merge(ListIterator first, ListIterator last) {
+        struct Source {
+            Node<T> *m_node;
+            std::size_t m_order;
+        };
+        // std heaps keep the largest element on top, so "less" means "comes later"
+        auto comesLater = [this](const Source &lhs, const Source &rhs) {
+            if (m_compare(rhs.m_node->m_data, lhs.m_node->m_data)) {
+                return true;
+            }
+            return !m_compare(lhs.m_node->m_data, rhs.m_node->m_data) && lhs.m_order > rhs.m_order;
+        };
+
+        std::vector<SortedList<T, Compare, Alloc> *> lists;
+        std::vector<SortedList<T, Compare, Alloc> *> foreign;
+        for (ListIterator current = first; current != last; ++current) {
+            SortedList<T, Compare, Alloc> &list = *current;
+            if (&list == this || list.m_head == nullptr) {
+                continue;
+            }
+            if (m_nodeAllocator == list.m_nodeAllocator) {
+                lists.push_back(&list);
+            } else {
+                foreign.push_back(&list);
+            }
+        }
+        std::vector<SortedList<T, Compare, Alloc>> adopted;
+        adopted.reserve(foreign.size());
+        for (SortedList<T, Compare, Alloc> *list : foreign) {
+            adopted.emplace_back(m_compare, Alloc(m_nodeAllocator));
+            adopted.back().appendAll(*list);
+        }
+        lists.reserve(lists.size() + adopted.size());
+        std::vector<Source> heap;
+        heap.reserve(lists.size() + adopted.size() + 1);
+
+        // nothing below throws
+        for (SortedList<T, Compare, Alloc> *list : foreign) {
+            list->deleteAllNodes();
+        }
+        for (SortedList<T, Compare, Alloc> &list : adopted) {
+            lists.push_back(&list);
+        }
+        if (lists.empty()) {
+            return;
+        }
+        if (m_head != nullptr) {
+            heap.push_back(Source{m_head, 0});
+        }
+        for (std::size_t i = 0; i < lists.size(); ++i) {
+            heap.push_back(Source{lists[i]->m_head, i + 1});
+            m_length += lists[i]->m_length;
+            lists[i]->releaseNodes();
+        }
+        std::make_heap(heap.begin(), heap.end(), comesLater);
+
+        Node<T> *tail = nullptr;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), comesLater);
+            Source &source = heap.back();
+            Node<T> *next = source.m_node;
+            if (tail == nullptr) {
+                m_head = next;
+            } else {
+                tail->m_next = next;
+            }
+            next->m_prev = tail;
+            tail = next;
+            source.m_node = next->m_next;
+            if (source.m_node == nullptr) {
+                heap.pop_back();
+            } else {
+                std::push_heap(heap.begin(), heap.end(), comesLater);
+            }
+        }
+        m_end = tail;
+        rebuildIndex();
+    }
+
+    /*
+     * Calls operation on every element for which condition returns true, changing it in
+     * place, and moves only those nodes to their new positions. Nothing is allocated.
+     * Updated elements keep their relative order among equals and go in front of
+     * untouched equal elements. If condition or operation throws, every node is put
+     * back into the list. Returns the number of updated elements.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class Condition, class Operation>
+    int SortedList<T, Compare, Alloc>::update_if(Condition condition, Operation operation) {
+        Node<T> *detached = nullptr;
+        int updated = 0;
+        try {
+            Node<T> *current = m_head;
+            while (current != nullptr) {
+                Node<T> *next = current->m_next;
+                if (condition(current->m_data)) {
+                    detachNode(current);
+                    current->m_next = detached;
+                    detached = current;
+                    updated++;
                 }
+                current = next;
+            }
+            for (Node<T> *node = detached; node != nullptr; node = node->m_next) {
+                operation(node->m_data);
             }
-            m_length++;
         } catch (...) {
-            delete new_node;
+            attachAll(detached);
             throw;
         }
+        // the stack holds the nodes last to first, which keeps ties in their old order
+        attachAll(detached);
+        return updated;
     }
 
-    template<class T>
-    int SortedList<T>::length() const {
+    /*
+     * Calls operation on the element iterator points to, changing it in place, and
+     * moves that node to its new position. The iterator stays valid. If operation
+     * throws, the node is put back where its value now belongs.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class Operation>
+    void SortedList<T, Compare, Alloc>::update(const ConstIterator &iterator, Operation operation) {
+        if (iterator.m_node == nullptr || iterator.m_SortedList != this) {
+            return;
+        }
+        Node<T> *node = iterator.m_node;
+        detachNode(node);
+        try {
+            operation(node->m_data);
+        } catch (...) {
+            attachNode(node);
+            throw;
+        }
+        attachNode(node);
+    }
+
+    // Returns the first element equivalent to value (neither goes in front of the other), or end().
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator SortedList<T, Compare, Alloc>::find(const T &value) const {
+        IndexNode<T> *update[MAX_LEVEL];
+        Node<T> *previous = findPredecessor(value, update);
+        Node<T> *candidate = (previous == nullptr) ? m_head : previous->m_next;
+        if (candidate == nullptr || m_compare(value, candidate->m_data)) {
+            return end();
+        }
+        return ConstIterator(this, candidate);
+    }
+
+    template<class T, class Compare, class Alloc>
+    int SortedList<T, Compare, Alloc>::length() const {
         return m_length;
     }
 
-    template<class T>
+    template<class T, class Compare, class Alloc>
+    Alloc SortedList<T, Compare, Alloc>::get_allocator() const {
+        return Alloc(m_nodeAllocator);
+    }
+
+    template<class T, class Compare, class Alloc>
+    template<class Condition>
+    SortedList<T, Compare, Alloc> SortedList<T, Compare, Alloc>::filter(Condition condition) const {
+        return filtered(condition).toList();
+    }
+
+    template<class T, class Compare, class Alloc>
+    template<class Operation>
+    SortedList<T, Compare, Alloc> SortedList<T, Compare, Alloc>::apply(Operation operation) const {
+        return transformed(operation).toList();
+    }
+
+    /*
+     * Parallel version of filter: the list is cut into chunks that are scanned on the
+     * threads of the policy's pool, then the selected elements are joined in order.
+     * condition is called concurrently and must be safe to call that way. Gives the same
+     * list as filter(condition).
+     */
+    template<class T, class Compare, class Alloc>
     template<class Condition>
-    SortedList<T> SortedList<T>::filter(Condition condition) const {
-        SortedList<T> result;
-        for (ConstIterator i = this->begin(); i != this->end(); ++i) {
-            if (condition(*i)) {
-                result.insert(*i);
+    SortedList<T, Compare, Alloc> SortedList<T, Compare, Alloc>::filter(Condition condition,
+                                                                       const ParallelPolicy &policy) const {
+        ThreadPool &pool = policy.pool();
+        if (m_length < policy.m_threshold || pool.size() < 2) {
+            return filter(condition);
+        }
+        std::vector<Node<T> *> starts = chunkStarts(pool.size() * CHUNKS_PER_THREAD);
+        SortedList<T, Compare, Alloc> result = emptyCopy();
+        std::vector<Chain> chains(starts.size(), Chain{nullptr, nullptr, 0});
+        std::vector<std::vector<const T *>> selected(PARALLEL_ALLOCATION ? 0 : starts.size());
+        try {
+            pool.run(starts.size(), [&starts, &condition, &result, &chains, &selected](std::size_t chunk) {
+                Node<T> *end = (chunk + 1 < starts.size()) ? starts[chunk + 1] : nullptr;
+                for (Node<T> *current = starts[chunk]; current != end; current = current->m_next) {
+                    if (!condition(current->m_data)) {
+                        continue;
+                    }
+                    if constexpr (PARALLEL_ALLOCATION) {
+                        linkToChain(chains[chunk], result.createNode(current->m_data));
+                    } else {
+                        selected[chunk].push_back(&current->m_data);
+                    }
+                }
+            });
+            if constexpr (!PARALLEL_ALLOCATION) {
+                for (std::size_t chunk = 0; chunk < selected.size(); ++chunk) {
+                    for (const T *value : selected[chunk]) {
+                        linkToChain(chains[chunk], result.createNode(*value));
+                    }
+                }
+            }
+        } catch (...) {
+            for (Chain &chain : chains) {
+                result.destroyChain(chain);
             }
+            throw;
         }
+        result.adoptChains(chains);
         return result;
     }
 
-    template<class T>
+    /*
+     * Parallel version of apply: every chunk of the list is transformed and sorted on
+     * its own thread, then the sorted chunks are merged pairwise, again in parallel.
+     * operation and the ordering are called concurrently and must be safe to call that
+     * way. Gives the same list as apply(operation).
+     */
+    template<class T, class Compare, class Alloc>
     template<class Operation>
-    SortedList<T> SortedList<T>::apply(Operation operation) const {
-        SortedList<T> result;
-        Node<T> *current = m_head;
-        while (current != nullptr) {
-            result.insert(operation(current->nodeGetData()));
-            current = current->m_next;
+    SortedList<T, Compare, Alloc> SortedList<T, Compare, Alloc>::apply(Operation operation,
+                                                                      const ParallelPolicy &policy) const {
+        ThreadPool &pool = policy.pool();
+        if (m_length < policy.m_threshold || pool.size() < 2) {
+            return apply(operation);
         }
+        std::vector<Node<T> *> starts = chunkStarts(pool.size() * CHUNKS_PER_THREAD);
+        std::vector<std::vector<T>> sorted(starts.size());
+        // apply() keeps equal results in reverse list order, so every chunk is reversed before its stable sort
+        pool.run(starts.size(), [this, &starts, &operation, &sorted](std::size_t chunk) {
+            Node<T> *end = (chunk + 1 < starts.size()) ? starts[chunk + 1] : nullptr;
+            for (Node<T> *current = starts[chunk]; current != end; current = current->m_next) {
+                sorted[chunk].push_back(operation(current->m_data));
+            }
+            std::reverse(sorted[chunk].begin(), sorted[chunk].end());
+            std::stable_sort(sorted[chunk].begin(), sorted[chunk].end(), m_compare);
+        });
+        // for the same reason a later chunk goes in front of the equal elements of an earlier one
+        for (std::size_t width = 1; width < sorted.size(); width *= 2) {
+            pool.run((sorted.size() + 2 * width - 1) / (2 * width), [this, &sorted, width](std::size_t pair) {
+                std::size_t low = pair * 2 * width;
+                std::size_t high = low + width;
+                if (high >= sorted.size()) {
+                    return;
+                }
+                std::vector<T> merged;
+                merged.reserve(sorted[low].size() + sorted[high].size());
+                std::merge(std::make_move_iterator(sorted[high].begin()), std::make_move_iterator(sorted[high].end()),
+                           std::make_move_iterator(sorted[low].begin()), std::make_move_iterator(sorted[low].end()),
+                           std::back_inserter(merged), m_compare);
+                sorted[low].swap(merged);
+                std::vector<T>().swap(sorted[high]);
+            });
+        }
+
+        std::vector<T> &values = sorted[0];
+        SortedList<T, Compare, Alloc> result = emptyCopy();
+        std::size_t parts = PARALLEL_ALLOCATION ? pool.size() : 1;
+        std::vector<Chain> chains(parts, Chain{nullptr, nullptr, 0});
+        try {
+            pool.run(parts, [&values, &result, &chains, parts](std::size_t part) {
+                std::size_t first = values.size() * part / parts;
+                std::size_t last = values.size() * (part + 1) / parts;
+                for (std::size_t i = first; i < last; ++i) {
+                    linkToChain(chains[part], result.createNode(std::move(values[i])));
+                }
+            });
+        } catch (...) {
+            for (Chain &chain : chains) {
+                result.destroyChain(chain);
+            }
+            throw;
+        }
+        result.adoptChains(chains);
         return result;
     }
 
-    template<class T>
-    typename SortedList<T>::ConstIterator SortedList<T>::begin() const {
+    // Lazy filter: nothing is copied until the view is iterated or turned into a list.
+    template<class T, class Compare, class Alloc>
+    template<class Condition>
+    FilteredView<SortedList<T, Compare, Alloc>, Condition>
+    SortedList<T, Compare, Alloc>::filtered(Condition condition) const {
+        return FilteredView<SortedList, Condition>(*this, *this, condition);
+    }
+
+    // Lazy apply: operation runs on every access, so dereference each position only once.
+    template<class T, class Compare, class Alloc>
+    template<class Operation>
+    TransformedView<SortedList<T, Compare, Alloc>, Operation>
+    SortedList<T, Compare, Alloc>::transformed(Operation operation) const {
+        return TransformedView<SortedList, Operation>(*this, *this, operation);
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator SortedList<T, Compare, Alloc>::begin() const {
         return ConstIterator(this, this->m_head);
     }
 
-    template<class T>
-    typename SortedList<T>::ConstIterator SortedList<T>::end() const {
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator SortedList<T, Compare, Alloc>::end() const {
         return ConstIterator(this, nullptr);
     }
 
-    template<class T>
-    class SortedList<T>::ConstIterator {
+    template<class T, class Compare, class Alloc>
+    class SortedList<T, Compare, Alloc>::ConstIterator {
     public:
         ~ConstIterator() = default;
 
@@ -244,20 +1211,20 @@ namespace mtm {
         friend class SortedList;
     };
 
-    template<class T>
-    SortedList<T>::ConstIterator::ConstIterator(const SortedList *sortedList, Node<T> *node) :
+    template<class T, class Compare, class Alloc>
+    SortedList<T, Compare, Alloc>::ConstIterator::ConstIterator(const SortedList *sortedList, Node<T> *node) :
             m_SortedList(sortedList), m_node(node) {}
 
-    template<class T>
-    const T &SortedList<T>::ConstIterator::operator*() const {
+    template<class T, class Compare, class Alloc>
+    const T &SortedList<T, Compare, Alloc>::ConstIterator::operator*() const {
         if (m_node == nullptr) {
             throw std::out_of_range("Iterator out of range");
         }
         return m_node->nodeGetData();
     }
 
-    template<class T>
-    typename SortedList<T>::ConstIterator &SortedList<T>::ConstIterator::operator++() {
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator &SortedList<T, Compare, Alloc>::ConstIterator::operator++() {
         if (m_node == nullptr) {
             throw std::out_of_range("Iterator out of range");
         }
@@ -265,59 +1232,515 @@ namespace mtm {
         return *this;
     }
 
-    template<class T>
-    typename SortedList<T>::ConstIterator SortedList<T>::ConstIterator::operator++(int) {
+    template<class T, class Compare, class Alloc>
+    typename SortedList<T, Compare, Alloc>::ConstIterator SortedList<T, Compare, Alloc>::ConstIterator::operator++(int) {
         ConstIterator result = *this;
         ++(*this);
         return result;
     }
 
-    template<class T>
-    bool SortedList<T>::ConstIterator::operator==(const ConstIterator &other) const {
+    template<class T, class Compare, class Alloc>
+    bool SortedList<T, Compare, Alloc>::ConstIterator::operator==(const ConstIterator &other) const {
         return (this->m_node == other.m_node && this->m_SortedList == other.m_SortedList);
     }
 
-    template<class T>
-    bool SortedList<T>::ConstIterator::operator!=(const ConstIterator &other) const {
+    template<class T, class Compare, class Alloc>
+    bool SortedList<T, Compare, Alloc>::ConstIterator::operator!=(const ConstIterator &other) const {
         return !(*this == other);
     }
 
-    template<class T>
-    void SortedList<T>::remove(const SortedList<T>::ConstIterator &iterator) {
-        if (iterator.m_node == nullptr) {
-            return;
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::destroyTower(Node<T> *node) noexcept {
+        IndexNode<T> *entry = node->m_index;
+        while (entry != nullptr) {
+            IndexNode<T> *up = entry->m_up;
+            destroyIndexNode(entry);
+            entry = up;
         }
+        node->m_index = nullptr;
+    }
 
-        Node<T> *current = this->m_head;
-        Node<T> *previous = nullptr;
+    /*
+     * Links a detached node, together with its own index entries, at the position its
+     * value belongs to: in front of equal elements, like insert.
+     */
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::attachNode(Node<T> *node) noexcept {
+        IndexNode<T> *update[MAX_LEVEL];
+        Node<T> *previous = findPredecessor(node->m_data, update);
 
-        if (current == iterator.m_node) {
-            Node<T> *toDelete = current;
-            m_head = m_head->m_next;
-            delete toDelete;
-            m_length--;
-            if (m_head == nullptr) {
-                m_end = nullptr;
+        node->m_prev = previous;
+        if (previous == nullptr) {
+            node->m_next = m_head;
+            m_head = node;
+        } else {
+            node->m_next = previous->m_next;
+            previous->m_next = node;
+        }
+        if (node->m_next == nullptr) {
+            m_end = node;
+        } else {
+            node->m_next->m_prev = node;
+        }
+
+        int level = 0;
+        for (IndexNode<T> *entry = node->m_index; entry != nullptr; entry = entry->m_up) {
+            if (level >= m_levels) {
+                update[level] = nullptr;
+                m_levels = level + 1;
             }
-            return;
+            IndexNode<T> *&link = (update[level] == nullptr) ? m_index[level] : update[level]->m_right;
+            entry->m_left = update[level];
+            entry->m_right = link;
+            if (link != nullptr) {
+                link->m_left = entry;
+            }
+            link = entry;
+            level++;
+        }
+        m_length++;
+    }
+
+    // Takes node out of the chain and the index without any search; its index entries stay with it.
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::detachNode(Node<T> *node) noexcept {
+        int level = 0;
+        for (IndexNode<T> *entry = node->m_index; entry != nullptr; entry = entry->m_up) {
+            if (entry->m_left == nullptr) {
+                m_index[level] = entry->m_right;
+            } else {
+                entry->m_left->m_right = entry->m_right;
+            }
+            if (entry->m_right != nullptr) {
+                entry->m_right->m_left = entry->m_left;
+            }
+            level++;
+        }
+        while (m_levels > 0 && m_index[m_levels - 1] == nullptr) {
+            m_levels--;
+        }
+
+        if (node->m_prev == nullptr) {
+            m_head = node->m_next;
+        } else {
+            node->m_prev->m_next = node->m_next;
+        }
+        if (node->m_next == nullptr) {
+            m_end = node->m_prev;
+        } else {
+            node->m_next->m_prev = node->m_prev;
         }
+        m_length--;
+    }
 
-        while (current != nullptr && current != iterator.m_node) {
-            previous = current;
-            current = current->m_next;
+    // Pops every node of a stack linked through m_next and attaches it to the list.
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::attachAll(Node<T> *stack) noexcept {
+        while (stack != nullptr) {
+            Node<T> *next = stack->m_next;
+            attachNode(stack);
+            stack = next;
         }
+    }
+
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::unlinkNode(Node<T> *node) noexcept {
+        detachNode(node);
+        destroyTower(node);
+        destroyNode(node);
+    }
 
-        if (current == nullptr) {
+    template<class T, class Compare, class Alloc>
+    void SortedList<T, Compare, Alloc>::remove(const SortedList<T, Compare, Alloc>::ConstIterator &iterator) {
+        if (iterator.m_node == nullptr || iterator.m_SortedList != this) {
             return;
         }
+        unlinkNode(iterator.m_node);
+    }
 
-        Node<T> *toDelete = current;
-        previous->m_next = current->m_next;
-        if (current == m_end) {
-            m_end = previous;
+    /*
+     * Removes every element for which condition returns true in a single pass and
+     * returns how many were removed.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class Condition>
+    int SortedList<T, Compare, Alloc>::erase_if(Condition condition) {
+        int removed = 0;
+        Node<T> *current = m_head;
+        while (current != nullptr) {
+            Node<T> *next = current->m_next;
+            if (condition(current->m_data)) {
+                unlinkNode(current);
+                removed++;
+            }
+            current = next;
         }
-        delete toDelete;
-        m_length--;
+        return removed;
+    }
+
+    /**
+     * The elements of a source for which condition returns true, found while iterating.
+     * Nothing is copied or allocated until toList() is called. Iterators of the view
+     * behave like those of its source: dereferencing or incrementing at end() throws.
+     * condition is called again on every pass over the view. Over a source that computes
+     * its elements, such as a TransformedView, each element is computed once per pass
+     * and kept in the iterator, which then hands out a reference to that copy.
+     */
+    template<class Source, class Condition>
+    class FilteredView {
+    public:
+        using List = typename ViewTraits<FilteredView>::List;
+        class ConstIterator;
+
+        FilteredView(const Source &source, const List &list, Condition condition);
+
+        ConstIterator begin() const;
+        ConstIterator end() const;
+
+        template<class Next>
+        FilteredView<FilteredView, Next> filtered(Next condition) const;
+
+        template<class Operation>
+        TransformedView<FilteredView, Operation> transformed(Operation operation) const;
+
+        List toList() const;
+
+    private:
+        typename ViewTraits<Source>::Storage m_source;
+        const List *m_list;
+        mutable Condition m_condition;
+    };
+
+    template<class Source, class Condition>
+    class FilteredView<Source, Condition>::ConstIterator {
+    private:
+        using SourceReference = decltype(*std::declval<const typename Source::ConstIterator &>());
+        static constexpr bool CACHED = !std::is_reference<SourceReference>::value;
+
+    public:
+        using SourceIterator = typename Source::ConstIterator;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename std::decay<SourceReference>::type;
+        using reference = typename std::conditional<CACHED, const value_type &, SourceReference>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+
+        reference operator*() const;
+
+        bool operator!=(const ConstIterator &other) const;
+        ConstIterator &operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator &other) const;
+
+    private:
+        SourceIterator m_current;
+        SourceIterator m_end;
+        Condition *m_condition;
+        // The current element when the source computes it, so it is computed only once
+        typename std::conditional<CACHED, std::optional<value_type>, std::nullptr_t>::type m_value;
+
+        ConstIterator(SourceIterator current, SourceIterator end, Condition *condition);
+        void skipRejected();
+        friend class FilteredView;
+    };
+
+    template<class Source, class Condition>
+    FilteredView<Source, Condition>::FilteredView(const Source &source, const List &list, Condition condition) :
+            m_source(ViewTraits<Source>::store(source)), m_list(&list), m_condition(condition) {}
+
+    template<class Source, class Condition>
+    typename FilteredView<Source, Condition>::ConstIterator FilteredView<Source, Condition>::begin() const {
+        const Source &source = ViewTraits<Source>::get(m_source);
+        return ConstIterator(source.begin(), source.end(), &m_condition);
+    }
+
+    template<class Source, class Condition>
+    typename FilteredView<Source, Condition>::ConstIterator FilteredView<Source, Condition>::end() const {
+        const Source &source = ViewTraits<Source>::get(m_source);
+        return ConstIterator(source.end(), source.end(), &m_condition);
+    }
+
+    template<class Source, class Condition>
+    template<class Next>
+    FilteredView<FilteredView<Source, Condition>, Next> FilteredView<Source, Condition>::filtered(Next condition) const {
+        return FilteredView<FilteredView, Next>(*this, *m_list, condition);
+    }
+
+    template<class Source, class Condition>
+    template<class Operation>
+    TransformedView<FilteredView<Source, Condition>, Operation>
+    FilteredView<Source, Condition>::transformed(Operation operation) const {
+        return TransformedView<FilteredView, Operation>(*this, *m_list, operation);
+    }
+
+    /*
+     * Builds a list of the selected elements. Straight from a list they are already in
+     * order and are only appended, like filter(); after a transformation they are
+     * sorted like apply().
+     */
+    template<class Source, class Condition>
+    typename FilteredView<Source, Condition>::List FilteredView<Source, Condition>::toList() const {
+        List result = m_list->emptyCopy();
+        if constexpr (ViewTraits<Source>::IN_LIST_ORDER) {
+            for (ConstIterator i = begin(); i != end(); ++i) {
+                result.pushBack(*i);
+            }
+            result.rebuildIndex();
+        } else {
+            std::vector<typename ConstIterator::value_type> values;
+            for (ConstIterator i = begin(); i != end(); ++i) {
+                values.push_back(*i);
+            }
+            result.insertValues(values);
+        }
+        return result;
+    }
+
+    template<class Source, class Condition>
+    FilteredView<Source, Condition>::ConstIterator::ConstIterator(SourceIterator current, SourceIterator end,
+                                                                  Condition *condition) :
+            m_current(current), m_end(end), m_condition(condition), m_value() {
+        skipRejected();
+    }
+
+    template<class Source, class Condition>
+    void FilteredView<Source, Condition>::ConstIterator::skipRejected() {
+        if constexpr (CACHED) {
+            for (; m_current != m_end; ++m_current) {
+                m_value.emplace(*m_current);
+                if ((*m_condition)(*m_value)) {
+                    return;
+                }
+            }
+            m_value.reset();
+        } else {
+            while (m_current != m_end && !(*m_condition)(*m_current)) {
+                ++m_current;
+            }
+        }
+    }
+
+    template<class Source, class Condition>
+    typename FilteredView<Source, Condition>::ConstIterator::reference
+    FilteredView<Source, Condition>::ConstIterator::operator*() const {
+        if constexpr (CACHED) {
+            if (!m_value) {
+                throw std::out_of_range("Iterator out of range");
+            }
+            return *m_value;
+        } else {
+            return *m_current;
+        }
+    }
+
+    template<class Source, class Condition>
+    typename FilteredView<Source, Condition>::ConstIterator &FilteredView<Source, Condition>::ConstIterator::operator++() {
+        ++m_current;
+        skipRejected();
+        return *this;
+    }
+
+    template<class Source, class Condition>
+    typename FilteredView<Source, Condition>::ConstIterator
+    FilteredView<Source, Condition>::ConstIterator::operator++(int) {
+        ConstIterator result = *this;
+        ++(*this);
+        return result;
+    }
+
+    template<class Source, class Condition>
+    bool FilteredView<Source, Condition>::ConstIterator::operator==(const ConstIterator &other) const {
+        return m_current == other.m_current;
+    }
+
+    template<class Source, class Condition>
+    bool FilteredView<Source, Condition>::ConstIterator::operator!=(const ConstIterator &other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * The elements of a source passed through operation, computed on every dereference.
+     * The results are not in list order any more, so toList() sorts them, like apply().
+     * Nothing is copied or allocated until then.
+     */
+    template<class Source, class Operation>
+    class TransformedView {
+    public:
+        using List = typename ViewTraits<TransformedView>::List;
+        class ConstIterator;
+
+        TransformedView(const Source &source, const List &list, Operation operation);
+
+        ConstIterator begin() const;
+        ConstIterator end() const;
+
+        template<class Condition>
+        FilteredView<TransformedView, Condition> filtered(Condition condition) const;
+
+        template<class Next>
+        TransformedView<TransformedView, Next> transformed(Next operation) const;
+
+        List toList() const;
+
+    private:
+        typename ViewTraits<Source>::Storage m_source;
+        const List *m_list;
+        mutable Operation m_operation;
+    };
+
+    template<class Source, class Operation>
+    class TransformedView<Source, Operation>::ConstIterator {
+    public:
+        using SourceIterator = typename Source::ConstIterator;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename std::decay<decltype(std::declval<Operation &>()(
+                *std::declval<const SourceIterator &>()))>::type;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+
+        reference operator*() const;
+
+        bool operator!=(const ConstIterator &other) const;
+        ConstIterator &operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator &other) const;
+
+    private:
+        SourceIterator m_current;
+        Operation *m_operation;
+
+        ConstIterator(SourceIterator current, Operation *operation);
+        friend class TransformedView;
+    };
+
+    template<class Source, class Operation>
+    TransformedView<Source, Operation>::TransformedView(const Source &source, const List &list, Operation operation) :
+            m_source(ViewTraits<Source>::store(source)), m_list(&list), m_operation(operation) {}
+
+    template<class Source, class Operation>
+    typename TransformedView<Source, Operation>::ConstIterator TransformedView<Source, Operation>::begin() const {
+        return ConstIterator(ViewTraits<Source>::get(m_source).begin(), &m_operation);
+    }
+
+    template<class Source, class Operation>
+    typename TransformedView<Source, Operation>::ConstIterator TransformedView<Source, Operation>::end() const {
+        return ConstIterator(ViewTraits<Source>::get(m_source).end(), &m_operation);
+    }
+
+    template<class Source, class Operation>
+    template<class Condition>
+    FilteredView<TransformedView<Source, Operation>, Condition>
+    TransformedView<Source, Operation>::filtered(Condition condition) const {
+        return FilteredView<TransformedView, Condition>(*this, *m_list, condition);
+    }
+
+    template<class Source, class Operation>
+    template<class Next>
+    TransformedView<TransformedView<Source, Operation>, Next>
+    TransformedView<Source, Operation>::transformed(Next operation) const {
+        return TransformedView<TransformedView, Next>(*this, *m_list, operation);
+    }
+
+    template<class Source, class Operation>
+    typename TransformedView<Source, Operation>::List TransformedView<Source, Operation>::toList() const {
+        std::vector<typename ConstIterator::value_type> values;
+        if constexpr (std::is_same<Source, List>::value) {
+            values.reserve(m_list->length());
+        }
+        for (ConstIterator i = begin(); i != end(); ++i) {
+            values.push_back(*i);
+        }
+        List result = m_list->emptyCopy();
+        result.insertValues(values);
+        return result;
+    }
+
+    template<class Source, class Operation>
+    TransformedView<Source, Operation>::ConstIterator::ConstIterator(SourceIterator current, Operation *operation) :
+            m_current(current), m_operation(operation) {}
+
+    template<class Source, class Operation>
+    typename TransformedView<Source, Operation>::ConstIterator::reference
+    TransformedView<Source, Operation>::ConstIterator::operator*() const {
+        return (*m_operation)(*m_current);
+    }
+
+    template<class Source, class Operation>
+    typename TransformedView<Source, Operation>::ConstIterator &
+    TransformedView<Source, Operation>::ConstIterator::operator++() {
+        ++m_current;
+        return *this;
+    }
+
+    template<class Source, class Operation>
+    typename TransformedView<Source, Operation>::ConstIterator
+    TransformedView<Source, Operation>::ConstIterator::operator++(int) {
+        ConstIterator result = *this;
+        ++(*this);
+        return result;
+    }
+
+    template<class Source, class Operation>
+    bool TransformedView<Source, Operation>::ConstIterator::operator==(const ConstIterator &other) const {
+        return m_current == other.m_current;
+    }
+
+    template<class Source, class Operation>
+    bool TransformedView<Source, Operation>::ConstIterator::operator!=(const ConstIterator &other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * Visits the elements of several sorted lists in merged order without building a
+     * new list, using a heap over the current position in every list: O(total log k).
+     * Among equal elements the one from the earlier list is visited first. Works with
+     * any list type that is iterated in order through a ConstIterator; compare must
+     * be the ordering the lists are sorted by.
+     */
+    template<class List, class Visitor, class Compare>
+    void forEachMerged(const std::vector<const List *> &lists, Visitor visit, Compare compare) {
+        using Iterator = typename List::ConstIterator;
+        struct Cursor {
+            Iterator m_current;
+            Iterator m_end;
+            std::size_t m_order;
+        };
+        // std heaps keep the largest element on top, so "less" means "comes later"
+        auto comesLater = [&compare](const Cursor &lhs, const Cursor &rhs) {
+            if (compare(*rhs.m_current, *lhs.m_current)) {
+                return true;
+            }
+            return !compare(*lhs.m_current, *rhs.m_current) && lhs.m_order > rhs.m_order;
+        };
+
+        std::vector<Cursor> heap;
+        heap.reserve(lists.size());
+        for (std::size_t i = 0; i < lists.size(); ++i) {
+            if (lists[i]->begin() != lists[i]->end()) {
+                heap.push_back(Cursor{lists[i]->begin(), lists[i]->end(), i});
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), comesLater);
+
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), comesLater);
+            Cursor &cursor = heap.back();
+            visit(*cursor.m_current);
+            ++cursor.m_current;
+            if (cursor.m_current == cursor.m_end) {
+                heap.pop_back();
+            } else {
+                std::push_heap(heap.begin(), heap.end(), comesLater);
+            }
+        }
+    }
+
+    // forEachMerged for lists ordered by operator>.
+    template<class List, class Visitor>
+    void forEachMerged(const std::vector<const List *> &lists, Visitor visit) {
+        using Value = typename std::decay<decltype(*std::declval<typename List::ConstIterator>())>::type;
+        forEachMerged(lists, visit, Greater<Value>());
     }
 
 } // namespace mtm
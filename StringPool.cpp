@@ -0,0 +1,28 @@
+#include "StringPool.h"
+
+StringPool::Handle StringPool::intern(std::string_view text) {
+    auto found = m_strings.find(text);
+    if (found != m_strings.end()) {
+        return found->second;
+    }
+    Handle pooled = std::make_shared<const std::string>(text);
+    m_strings.emplace(std::string_view(*pooled), pooled);
+    return pooled;
+}
+
+std::size_t StringPool::purge() {
+    std::size_t dropped = 0;
+    for (auto entry = m_strings.begin(); entry != m_strings.end();) {
+        if (entry->second.use_count() == 1) {
+            entry = m_strings.erase(entry);
+            ++dropped;
+        } else {
+            ++entry;
+        }
+    }
+    return dropped;
+}
+
+std::size_t StringPool::size() const {
+    return m_strings.size();
+}
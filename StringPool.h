@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Pool of immutable strings shared by handle.
+ *
+ * Interning the same text twice returns the same handle, so tasks with equal
+ * descriptions share a single heap copy. Handles stay valid for as long as anyone
+ * holds them, even after the pool itself is destroyed. A pool is not thread-safe.
+ */
+class StringPool {
+public:
+    using Handle = std::shared_ptr<const std::string>;
+
+    /**
+     * @brief Returns the pooled copy of text, adding it to the pool if needed.
+     *
+     * @param text The text to intern.
+     * @return Handle A handle to the pooled string.
+     */
+    Handle intern(std::string_view text);
+
+    /**
+     * @brief Drops the strings that are no longer referenced outside of the pool.
+     *
+     * @return std::size_t The number of strings dropped.
+     */
+    std::size_t purge();
+
+    /**
+     * @brief Gets the number of distinct strings in the pool.
+     *
+     * @return std::size_t The number of pooled strings.
+     */
+    std::size_t size() const;
+
+private:
+    std::unordered_map<std::string_view, Handle> m_strings; // Keys view the pooled strings
+};
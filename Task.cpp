@@ -1,25 +1,114 @@
 
 #include "Task.h"
+#include <new>
+#include <utility>
 
 // Constructor
 Task::Task(int priority, TaskType type, const string &desc)
-    : m_description(desc), m_priority(priority), m_type(type)
+    : m_type(type), m_interned(false), m_text(desc)
 {
-    // enforce priority range of 0-100
-    // 0 is lowest priority, 100 is highest
-    if (m_priority < 0)
-    {
-        m_priority = 0;
-    }
-    else if (m_priority > 100)
-    {
-        m_priority = 100;
-    }
+    setPriority(priority);
 }
 
 Task::Task(int priority, const string &desc)
     : Task(priority, TaskType::General, desc) {}
 
+Task::Task(int priority, TaskType type, string &&desc)
+    : m_type(type), m_interned(false), m_text(std::move(desc))
+{
+    setPriority(priority);
+}
+
+Task::Task(int priority, string &&desc)
+    : Task(priority, TaskType::General, std::move(desc)) {}
+
+Task::Task(int priority, TaskType type, StringPool &pool, std::string_view desc)
+    : Task(priority, type, desc.empty() ? nullptr : pool.intern(desc)) {}
+
+Task::Task(int priority, TaskType type, StringPool::Handle desc)
+    : m_type(type), m_interned(desc && !desc->empty())
+{
+    if (m_interned) {
+        new (&m_shared) StringPool::Handle(std::move(desc));
+    } else {
+        new (&m_text) string();
+    }
+    setPriority(priority);
+}
+
+Task::Task(const Task &other)
+    : m_id(other.m_id), m_priority(other.m_priority), m_type(other.m_type), m_interned(other.m_interned)
+{
+    if (m_interned) {
+        new (&m_shared) StringPool::Handle(other.m_shared);
+    } else {
+        new (&m_text) string(other.m_text);
+    }
+}
+
+Task::Task(Task &&other) noexcept
+    : m_id(other.m_id), m_priority(other.m_priority), m_type(other.m_type), m_interned(other.m_interned)
+{
+    if (m_interned) {
+        new (&m_shared) StringPool::Handle(std::move(other.m_shared));
+        other.unshareDescription();
+    } else {
+        new (&m_text) string(std::move(other.m_text));
+    }
+}
+
+Task &Task::operator=(const Task &other) {
+    if (this != &other) {
+        *this = Task(other);
+    }
+    return *this;
+}
+
+Task &Task::operator=(Task &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    if (m_interned == other.m_interned) {
+        if (m_interned) {
+            m_shared = std::move(other.m_shared);
+            other.unshareDescription();
+        } else {
+            m_text = std::move(other.m_text);
+        }
+    } else {
+        destroyDescription();
+        m_interned = other.m_interned;
+        if (m_interned) {
+            new (&m_shared) StringPool::Handle(std::move(other.m_shared));
+            other.unshareDescription();
+        } else {
+            new (&m_text) string(std::move(other.m_text));
+        }
+    }
+    m_id = other.m_id;
+    m_priority = other.m_priority;
+    m_type = other.m_type;
+    return *this;
+}
+
+Task::~Task() {
+    destroyDescription();
+}
+
+void Task::destroyDescription() noexcept {
+    if (m_interned) {
+        m_shared.~shared_ptr();
+    } else {
+        m_text.~string();
+    }
+}
+
+void Task::unshareDescription() noexcept {
+    m_shared.~shared_ptr();
+    new (&m_text) string();
+    m_interned = false;
+}
+
 // Getters and setters
 int Task::getId() const {
     return m_id;
@@ -33,19 +122,44 @@ TaskType Task::getType() const {
     return m_type;
 }
 
-string Task::getDescription() const {
-    return m_description;
+const string& Task::getDescription() const {
+    return m_interned ? *m_shared : m_text;
+}
+
+void Task::internDescription(StringPool &pool) {
+    if (m_interned) {
+        m_shared = pool.intern(*m_shared);
+    } else if (!m_text.empty()) {
+        StringPool::Handle pooled = pool.intern(m_text);
+        m_text.~string();
+        new (&m_shared) StringPool::Handle(std::move(pooled));
+        m_interned = true;
+    }
 }
 
 int Task::getPriority() const {
     return m_priority;
 }
 
+void Task::setPriority(int newPriority) {
+    // enforce priority range of 0-100
+    // 0 is lowest priority, 100 is highest
+    if (newPriority < 0)
+    {
+        newPriority = 0;
+    }
+    else if (newPriority > 100)
+    {
+        newPriority = 100;
+    }
+    m_priority = static_cast<std::uint8_t>(newPriority);
+}
+
 
 // Overloaded operators
 ostream &operator<<(ostream& os, const Task& task) {
-    os << "Task ID: " << task.m_id << ", Priority: " << task.m_priority;
-    os << ", Type: " << taskTypeToString(task.m_type) << ", Description: " << task.m_description;
+    os << "Task ID: " << task.m_id << ", Priority: " << task.getPriority();
+    os << ", Type: " << taskTypeToString(task.m_type) << ", Description: " << task.getDescription();
     return os;
 }
 
@@ -1,8 +1,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include "StringPool.h"
 
 using std::ostream;
 using std::string;
@@ -10,7 +13,7 @@ using std::string;
 /**
  * @brief Enum class representing different types of tasks.
  */
-enum class TaskType {
+enum class TaskType : std::uint8_t {
     Meeting,
     Presentation,
     Documentation,
@@ -33,13 +36,25 @@ string taskTypeToString(TaskType type);
 
 /**
  * @brief Class representing a task.
+ *
+ * The description is a private string unless it was interned in a StringPool, in which
+ * case the task holds a handle to the pooled copy instead. Only interned tasks pay for
+ * the handle's reference count when they are copied.
  */
 class Task {
 private:
     int m_id;
-    string m_description;
-    int m_priority;
+    std::uint8_t m_priority; // Always in range [0, 100]
     TaskType m_type;
+    bool m_interned; // Selects the active member of the union below
+    union {
+        string m_text; // Private description
+        StringPool::Handle m_shared; // Interned description, never null or empty
+    };
+
+    void destroyDescription() noexcept;
+    // Replaces the interned member, moved out or not, with an empty private description
+    void unshareDescription() noexcept;
 
 public:
     /**
@@ -59,6 +74,48 @@ public:
      */
     Task(int priority, const string& desc = "");
 
+    /**
+     * @brief Constructor to create a Task object that takes over its description.
+     *
+     * @param priority The priority of the task, enforced to be in range [0, 100].
+     * @param type The type of the task.
+     * @param desc The description of the task, moved into the task.
+     */
+    Task(int priority, TaskType type, string&& desc);
+
+    /**
+     * @brief Constructor to create a Task object with a default type that takes over its description.
+     *
+     * @param priority The priority of the task, enforced to be in range [0, 100].
+     * @param desc The description of the task, moved into the task.
+     */
+    Task(int priority, string&& desc);
+
+    /**
+     * @brief Constructor to create a Task object whose description is interned in a pool.
+     *
+     * @param priority The priority of the task, enforced to be in range [0, 100].
+     * @param type The type of the task.
+     * @param pool The pool that will hold the description.
+     * @param desc The description of the task.
+     */
+    Task(int priority, TaskType type, StringPool& pool, std::string_view desc);
+
+    /**
+     * @brief Constructor to create a Task object that shares a description held by a handle.
+     *
+     * @param priority The priority of the task, enforced to be in range [0, 100].
+     * @param type The type of the task.
+     * @param desc The description of the task, null or empty for none.
+     */
+    Task(int priority, TaskType type, StringPool::Handle desc);
+
+    Task(const Task& other);
+    Task(Task&& other) noexcept;
+    Task& operator=(const Task& other);
+    Task& operator=(Task&& other) noexcept;
+    ~Task();
+
     /**
      * @brief Gets the ID of the task.
      *
@@ -76,9 +133,18 @@ public:
     /**
      * @brief Gets the description of the task.
      *
-     * @return string The description of the task.
+     * @return const string& The description of the task.
+     */
+    const string& getDescription() const;
+
+    /**
+     * @brief Replaces the description of the task with its interned copy from a pool.
+     *
+     * An empty description stays private, since it needs no storage.
+     *
+     * @param pool The pool that will hold the description.
      */
-    string getDescription() const;
+    void internDescription(StringPool& pool);
 
     /**
      * @brief Gets the priority of the task.
@@ -87,6 +153,13 @@ public:
      */
     int getPriority() const;
 
+    /**
+     * @brief Sets the priority of the task.
+     *
+     * @param newPriority The new priority, enforced to be in range [0, 100].
+     */
+    void setPriority(int newPriority);
+
     /**
      * @brief Gets the type of the task.
      *
@@ -112,4 +185,21 @@ public:
      * @return false If the priority of lhs is not greater than that of rhs.
      */
     friend bool operator>(const Task& lhs, const Task& rhs);
+
+    friend struct TaskKey;
+};
+
+/**
+ * @brief Extracts the sort key of a task as one integer.
+ *
+ * A task with a larger key goes first, which gives exactly the order of operator>:
+ * higher priority first, then lower ID first. Unlike operator>, the extraction is
+ * inline, so a list ordered by the key compares tasks without any call.
+ */
+struct TaskKey {
+    std::uint64_t operator()(const Task& task) const noexcept {
+        // lower IDs go first, so the ID is stored inverted; flipping the sign bit keeps negative IDs in order
+        std::uint32_t id = static_cast<std::uint32_t>(task.m_id) ^ 0x80000000u;
+        return (static_cast<std::uint64_t>(task.m_priority) << 32) | static_cast<std::uint32_t>(~id);
+    }
 };
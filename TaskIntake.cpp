@@ -0,0 +1,97 @@
+#include "TaskIntake.h"
+#include <utility>
+#include <vector>
+
+TaskIntake::TaskIntake(TaskManager &manager, std::size_t capacity, std::size_t batchSize)
+    : m_manager(manager), m_ring(capacity), m_batchSize(batchSize > 0 ? batchSize : 1),
+      m_applied(0), m_sleeping(false), m_error(nullptr), m_stopping(false) {
+    m_applier = std::thread(&TaskIntake::applierLoop, this);
+}
+
+TaskIntake::~TaskIntake() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_applier.join();
+}
+
+bool TaskIntake::trySubmit(std::string_view personName, Task &&task) {
+    Submission submission{std::string(personName), std::move(task)};
+    if (!m_ring.tryPush(std::move(submission))) {
+        task = std::move(submission.m_task);
+        return false;
+    }
+    wakeApplier();
+    return true;
+}
+
+void TaskIntake::submit(std::string_view personName, Task task) {
+    Submission submission{std::string(personName), std::move(task)};
+    while (!m_ring.tryPush(std::move(submission))) {
+        wakeApplier();
+        std::this_thread::yield();
+    }
+    wakeApplier();
+}
+
+// Pairs with the fence in applierLoop(): either the applier sees the new submission or this sees it asleep.
+void TaskIntake::wakeApplier() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+}
+
+void TaskIntake::flush() {
+    // the ring is drained in push order, so this covers every submission made before the call
+    std::size_t target = m_ring.pushed();
+    while (m_applied.load(std::memory_order_acquire) < target) {
+        wakeApplier();
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskIntake::applierLoop() {
+    while (true) {
+        std::vector<std::pair<std::string, Task>> batch;
+        std::size_t applied = 0;
+        try {
+            // with room for a whole batch, moving submissions out of the ring cannot fail
+            batch.reserve(m_batchSize);
+            m_ring.drain(m_batchSize, [&batch, &applied](Submission &&submission) {
+                applied++;
+                batch.emplace_back(std::move(submission.m_personName), std::move(submission.m_task));
+            });
+            m_manager.assignTasks(std::move(batch));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+        if (applied > 0) {
+            m_applied.fetch_add(applied, std::memory_order_release);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_wake.wait(lock, [this]() {
+            return m_stopping || !m_ring.empty();
+        });
+        m_sleeping.store(false, std::memory_order_relaxed);
+        if (m_stopping && m_ring.empty()) {
+            return;
+        }
+    }
+}
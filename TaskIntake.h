@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "MpscRing.h"
+#include "Task.h"
+#include "TaskManager.h"
+
+/**
+ * @brief Intake stage that queues task assignments for a TaskManager.
+ *
+ * Any number of threads submit tasks into a lock-free ring, and a single applier thread
+ * drains it in batches and hands each batch to TaskManager::assignTasks, so the tasks are
+ * assigned in submission order. Submitters never touch the manager's locks, so they do
+ * not wait behind threads completing tasks. When the ring is full, submit() waits for
+ * room. The manager must be in concurrent mode if other threads use it while the intake
+ * is running.
+ */
+class TaskIntake {
+private:
+    /**
+     * @brief A task waiting to be assigned.
+     */
+    struct Submission {
+        std::string m_personName;
+        Task m_task;
+    };
+
+    TaskManager &m_manager;
+    mtm::MpscRing<Submission> m_ring;
+    std::size_t m_batchSize;
+    std::atomic<std::size_t> m_applied; // Submissions taken from the ring, in push order
+    std::atomic<bool> m_sleeping; // Set while the applier waits for submissions
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::exception_ptr m_error; // First failed assignment, guarded by m_mutex
+    bool m_stopping;
+    std::thread m_applier;
+
+    void applierLoop();
+    void wakeApplier();
+
+public:
+    /**
+     * @brief Starts the applier thread of an intake in front of manager.
+     *
+     * @param manager The TaskManager the tasks are assigned to.
+     * @param capacity The number of submissions that fit in the ring.
+     * @param batchSize The most submissions assigned before the applier checks for new ones.
+     */
+    explicit TaskIntake(TaskManager &manager, std::size_t capacity = 65536, std::size_t batchSize = 1024);
+
+    /**
+     * @brief Assigns every pending submission, then stops the applier thread.
+     */
+    ~TaskIntake();
+
+    TaskIntake(const TaskIntake &other) = delete;
+    TaskIntake &operator=(const TaskIntake &other) = delete;
+
+    /**
+     * @brief Queues a task for a person, waiting while the ring is full.
+     *
+     * @param personName The name of the person to whom the task will be assigned.
+     * @param task The task to be assigned.
+     */
+    void submit(std::string_view personName, Task task);
+
+    /**
+     * @brief Queues a task for a person unless the ring is full.
+     *
+     * @param personName The name of the person to whom the task will be assigned.
+     * @param task The task to be assigned, left untouched if the ring is full.
+     * @return true if the task was queued.
+     */
+    bool trySubmit(std::string_view personName, Task &&task);
+
+    /**
+     * @brief Waits until every task submitted before the call has been assigned.
+     *
+     * A failed assignment drops the rest of its batch.
+     *
+     * @throws The first exception thrown by an assignment since the last flush.
+     */
+    void flush();
+};
@@ -1,118 +1,678 @@
-#include "TaskManager.h"
-#include <stdexcept>
-#include <iostream>
-
-TaskManager::TaskManager() : currentTaskId(0), personCount(0) {
-}
-
-int TaskManager::findPersonIndex(const std::string &personName) const {
-    for (int i = 0; i < personCount; ++i) {
-        if (employees[i].getName() == personName) {
-            return i;
-        }
-    }
-    return -1;
-}
-
-void TaskManager::assignTask(const std::string &personName, const Task &task) {
-    int index = findPersonIndex(personName);
-    if (index == -1) {
-        if (personCount >= MAX_PERSONS) {
-            throw std::runtime_error("Maximum number of persons reached.");
-        }
-        employees[personCount] = Person(personName); // Construct Person directly
-        index = personCount;
-        personCount++;
-    }
-
-    Task new_task(task.getPriority(), task.getType(), task.getDescription());
-    new_task.setId(getcurrentTaskID());
-    setcurrentTaskID();
-    employees[index].assignTask(new_task);
-}
-
-void TaskManager::completeTask(const std::string &personName) {
-    int index = findPersonIndex(personName);
-    if (index == -1) {
-        return;
-    }
-    try {
-        employees[index].completeTask();
-    } catch (const std::exception &e) {
-        throw std::runtime_error(std::string(e.what()));
-    }
-}
-
-void TaskManager::printAllEmployees() const {
-    for (int i = 0; i < personCount; ++i) {
-        std::cout << employees[i] << std::endl;
-    }
-}
-
-void TaskManager::printTasksByType(TaskType type) const {
-    SortedList<Task> result;
-    for (int employee_index = 0; employee_index < personCount; ++employee_index) {
-        const SortedList<Task> &current_tasks = employees[employee_index].getTasks(); // Access directly
-
-        for (typename SortedList<Task>::ConstIterator it = current_tasks.begin(); it != current_tasks.end(); ++it) {
-            if (it.operator*().getType() == type) {
-                result.insert(*it);
-            }
-        }
-    }
-    for (typename SortedList<Task>::ConstIterator it = result.begin(); it != result.end(); ++it) {
-        std::cout << *it << std::endl;
-    }
-}
-
-void TaskManager::printAllTasks() const {
-    SortedList<Task> result;
-    for (int priority = 100; priority >= 0; priority--) {
-        for (int employee_index = 0; employee_index < personCount; ++employee_index) {
-            const SortedList<Task> &current_tasks = employees[employee_index].getTasks();
-            for (typename SortedList<Task>::ConstIterator it = current_tasks.begin(); it != current_tasks.end(); ++it) {
-                if (it.operator*().getPriority() == priority) {
-                    result.insert(*it);
-                }
-            }
-        }
-    }
-    for (typename SortedList<Task>::ConstIterator it = result.begin(); it != result.end(); ++it) {
-        std::cout << *it << std::endl;
-    }
-}
-
-void TaskManager::bumpPriorityByType(TaskType type, int amount) {
-    if (amount < 0)
-        return;
-
-    for (int i = 0; i < personCount; ++i) {
-        const SortedList<Task>& tasks = employees[i].getTasks();
-        SortedList<Task> filteredTasks = tasks.filter([type](const Task& task) {
-            return task.getType() == type;
-        });
-        SortedList<Task> updatedTasks = filteredTasks.apply([amount](const Task& task) {
-            int newPriority = task.getPriority() + amount;
-            if (newPriority > 100) {
-                newPriority = 100;
-            }
-            if (newPriority < 0) {
-                newPriority = 0;
-            }
-            Task updatedTask(newPriority, task.getType(), task.getDescription());
-            updatedTask.setId(task.getId());
-            return updatedTask;
-        });
-        SortedList<Task> unaffectedTasks = tasks.filter([type](const Task& task) {
-            return task.getType() != type;
-        });
-        SortedList<Task> allUpdatedTasks;
-        for (typename SortedList<Task>::ConstIterator it = updatedTasks.begin(); it != updatedTasks.end(); ++it) {
-            allUpdatedTasks.insert(*it);
-        }
-        for (typename SortedList<Task>::ConstIterator it = unaffectedTasks.begin(); it != unaffectedTasks.end(); ++it) {
-            allUpdatedTasks.insert(*it);
-        }
-        employees[i].setTasks(allUpdatedTasks);
-    }
-}
+#include "TaskManager.h"
+#include "TaskSnapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace {
+    const std::size_t MIN_DESCRIPTIONS_PURGE_SIZE = 64;
+
+    // Writes bytes at offset, padding with zeros from position, the number of bytes already written
+    void writeSection(std::ostream &out, std::uint64_t &position, std::uint64_t offset, const void *data,
+                      std::size_t bytes) {
+        static const char padding[8] = {};
+        out.write(padding, static_cast<std::streamsize>(offset - position));
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+        if (!out) {
+            throw std::runtime_error("Failed to write snapshot.");
+        }
+        position = offset + bytes;
+    }
+
+    // Reads bytes at offset, skipping from position, the number of bytes already read
+    void readSection(std::istream &in, std::uint64_t &position, std::uint64_t offset, void *data, std::size_t bytes) {
+        in.ignore(static_cast<std::streamsize>(offset - position));
+        in.read(static_cast<char *>(data), static_cast<std::streamsize>(bytes));
+        if (!in) {
+            throw std::runtime_error("Snapshot is truncated.");
+        }
+        position = offset + bytes;
+    }
+
+    // Reads count values at offset in chunks, so a corrupt count cannot allocate more than the stream holds
+    template<class T>
+    void readArray(std::istream &in, std::uint64_t &position, std::uint64_t offset, std::vector<T> &values,
+                   std::uint64_t count) {
+        const std::uint64_t chunk = (std::uint64_t(1) << 20) / sizeof(T);
+        readSection(in, position, offset, nullptr, 0);
+        values.clear();
+        while (values.size() < count) {
+            std::size_t size = values.size();
+            std::size_t more = static_cast<std::size_t>(std::min(count - size, chunk));
+            values.resize(size + more);
+            readSection(in, position, position, values.data() + size, more * sizeof(T));
+        }
+    }
+
+    void checkSnapshot(bool condition) {
+        if (!condition) {
+            throw std::runtime_error("Snapshot is corrupt.");
+        }
+    }
+}
+
+TaskManager::TaskManager() : currentTaskId(0) {
+}
+
+TaskManager::TaskManager(bool intern) : TaskManager(intern, false) {
+}
+
+TaskManager::TaskManager(bool intern, bool concurrent)
+    : currentTaskId(0), internDescriptions(intern),
+      descriptionsPurgeSize(MIN_DESCRIPTIONS_PURGE_SIZE), concurrent(concurrent) {
+}
+
+std::unique_lock<std::mutex> TaskManager::lockIfConcurrent(std::mutex &mutex) {
+    if (!concurrent) {
+        return std::unique_lock<std::mutex>(mutex, std::defer_lock);
+    }
+    return std::unique_lock<std::mutex>(mutex);
+}
+
+std::shared_lock<std::shared_mutex> TaskManager::shareStructure() const {
+    if (!concurrent) {
+        return std::shared_lock<std::shared_mutex>(structureMutex, std::defer_lock);
+    }
+    return std::shared_lock<std::shared_mutex>(structureMutex);
+}
+
+std::unique_lock<std::shared_mutex> TaskManager::lockStructure() const {
+    if (!concurrent) {
+        return std::unique_lock<std::shared_mutex>(structureMutex, std::defer_lock);
+    }
+    return std::unique_lock<std::shared_mutex>(structureMutex);
+}
+
+int TaskManager::findPersonIndex(std::string_view personName) const {
+    auto found = employeeIndex.find(personName);
+    if (found == employeeIndex.end()) {
+        return -1;
+    }
+    return found->second;
+}
+
+// Needs the structure to itself; another thread may have added the person meanwhile.
+int TaskManager::addPerson(std::string_view personName) {
+    int index = findPersonIndex(personName);
+    if (index != -1) {
+        return index;
+    }
+    index = static_cast<int>(employees.size());
+    employeeMutexes.emplace_back();
+    try {
+        employees.emplace_back(std::string(personName));
+    } catch (...) {
+        employeeMutexes.pop_back();
+        throw;
+    }
+    try {
+        employeeIndex.emplace(employees.back().getName(), index);
+    } catch (...) {
+        employees.pop_back();
+        employeeMutexes.pop_back();
+        throw;
+    }
+    return index;
+}
+
+int TaskManager::stripeOf(int taskId) {
+    return static_cast<int>(static_cast<unsigned int>(taskId) % LOCATION_STRIPES);
+}
+
+void TaskManager::internDescription(Task &task) {
+    std::unique_lock<std::mutex> poolLock = lockIfConcurrent(descriptionsMutex);
+    // drop descriptions of finished tasks once the pool has doubled since the last purge
+    if (descriptions.size() >= descriptionsPurgeSize) {
+        descriptions.purge();
+        descriptionsPurgeSize = std::max(MIN_DESCRIPTIONS_PURGE_SIZE, 2 * descriptions.size());
+    }
+    task.internDescription(descriptions);
+}
+
+void TaskManager::assignTask(std::string_view personName, const Task &task) {
+    assignTask(personName, Task(task));
+}
+
+void TaskManager::assignTask(std::string_view personName, Task &&task) {
+    std::shared_lock<std::shared_mutex> structure = shareStructure();
+    int index = findPersonIndex(personName);
+    if (index == -1) {
+        if (concurrent) {
+            structure.unlock();
+            {
+                std::unique_lock<std::shared_mutex> exclusive(structureMutex);
+                index = addPerson(personName);
+            }
+            structure.lock();
+        } else {
+            index = addPerson(personName);
+        }
+    }
+
+    int taskId = currentTaskId.fetch_add(1, std::memory_order_relaxed);
+    task.setId(taskId);
+    if (internDescriptions) {
+        internDescription(task);
+    }
+    int type = static_cast<int>(task.getType());
+    std::unique_lock<std::mutex> locationLock = lockIfConcurrent(locationMutexes[stripeOf(taskId)]);
+    std::unique_lock<std::mutex> personLock = lockIfConcurrent(employeeMutexes[index]);
+    std::unique_lock<std::mutex> typeLock = lockIfConcurrent(typeMutexes[type]);
+    placeTask(index, std::move(task));
+}
+
+void TaskManager::assignTasks(std::vector<std::pair<std::string, Task>> tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+
+    // each name is looked up once, however many tasks it has in the batch
+    std::unordered_map<std::string_view, int> owners;
+    std::vector<int> indexes;
+    indexes.reserve(tasks.size());
+    for (const std::pair<std::string, Task> &entry : tasks) {
+        auto owner = owners.find(entry.first);
+        if (owner == owners.end()) {
+            owner = owners.emplace(entry.first, addPerson(entry.first)).first;
+        }
+        indexes.push_back(owner->second);
+    }
+
+    int firstId = currentTaskId.fetch_add(static_cast<int>(tasks.size()), std::memory_order_relaxed);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        Task &task = tasks[i].second;
+        task.setId(firstId + static_cast<int>(i));
+        if (internDescriptions) {
+            internDescription(task);
+        }
+        placeTask(indexes[i], std::move(task));
+    }
+}
+
+// The caller holds the locks of the task's stripe, of its owner and of its type.
+void TaskManager::placeTask(int index, Task &&task) {
+    TaskQueue::ConstIterator assigned = employees[index].assignTask(std::move(task));
+    const Task &new_task = *assigned;
+    SortedList<IndexedTask> &bucket = tasksByType[static_cast<int>(new_task.getType())];
+    SortedList<IndexedTask>::ConstIterator entry = bucket.end();
+    try {
+        entry = bucket.insert(IndexedTask{new_task.getPriority(), new_task.getId(), index, assigned});
+        taskLocations[stripeOf(new_task.getId())].emplace(new_task.getId(), TaskLocation{index, assigned, entry});
+    } catch (...) {
+        bucket.remove(entry);
+        employees[index].removeTask(assigned);
+        throw;
+    }
+}
+
+TaskManager::TaskLocationMap::iterator TaskManager::findTask(TaskLocationMap &locations, int taskId) {
+    auto location = locations.find(taskId);
+    if (location == locations.end()) {
+        throw std::runtime_error("No task with this ID.");
+    }
+    return location;
+}
+
+// The caller holds the locks of the task's stripe and of its owner.
+void TaskManager::removeTask(TaskLocationMap &locations, TaskLocationMap::iterator location) {
+    const TaskLocation &task = location->second;
+    int type = static_cast<int>((*task.m_task).getType());
+    {
+        std::unique_lock<std::mutex> typeLock = lockIfConcurrent(typeMutexes[type]);
+        tasksByType[type].remove(task.m_typeEntry);
+    }
+    employees[task.m_personIndex].removeTask(task.m_task);
+    locations.erase(location);
+}
+
+void TaskManager::completeTask(std::string_view personName) {
+    {
+        std::shared_lock<std::shared_mutex> structure = shareStructure();
+        int index = findPersonIndex(personName);
+        if (index == -1) {
+            return;
+        }
+        // the stripe is locked before the owner, so the highest priority task is checked again once both are held
+        while (true) {
+            int taskId = 0;
+            {
+                std::unique_lock<std::mutex> personLock = lockIfConcurrent(employeeMutexes[index]);
+                if (workStealing && employees[index].getTasks().length() == 0) {
+                    break;
+                }
+                try {
+                    taskId = employees[index].getHighestPriorityTask().getId();
+                } catch (const std::exception &e) {
+                    throw std::runtime_error(std::string(e.what()));
+                }
+            }
+            int stripe = stripeOf(taskId);
+            std::unique_lock<std::mutex> locationLock = lockIfConcurrent(locationMutexes[stripe]);
+            std::unique_lock<std::mutex> personLock = lockIfConcurrent(employeeMutexes[index]);
+            const TaskQueue &tasks = employees[index].getTasks();
+            if (tasks.length() > 0 && (*tasks.begin()).getId() == taskId) {
+                removeTask(taskLocations[stripe], findTask(taskLocations[stripe], taskId));
+                return;
+            }
+        }
+    }
+
+    // an idle person takes work from the most loaded employee first
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    int index = findPersonIndex(personName);
+    if (employees[index].getTasks().length() == 0 && !stealTaskFor(index)) {
+        throw std::runtime_error("No tasks assigned to this person.");
+    }
+    removeHighestPriorityTask(index);
+}
+
+int TaskManager::completeTasks(std::string_view personName, int count) {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    int index = findPersonIndex(personName);
+    if (index == -1) {
+        return 0;
+    }
+    const TaskQueue &tasks = employees[index].getTasks();
+    int completed = 0;
+    while (completed < count && tasks.length() > 0) {
+        removeHighestPriorityTask(index);
+        completed++;
+    }
+    return completed;
+}
+
+// The caller holds the structure to itself.
+void TaskManager::removeHighestPriorityTask(int index) {
+    int taskId = (*employees[index].getTasks().begin()).getId();
+    TaskLocationMap &locations = taskLocations[stripeOf(taskId)];
+    removeTask(locations, findTask(locations, taskId));
+}
+
+/*
+ * The caller holds the structure to itself. The victim must be left with at least as many
+ * tasks as the thief, so stealing never just moves the imbalance. The stolen task is added
+ * to the thief before it leaves the victim, so a failed allocation changes nothing.
+ */
+bool TaskManager::stealTaskFor(int index) {
+    int victim = -1;
+    int victimLoad = employees[index].getTasks().length() + 1;
+    for (int i = 0; i < static_cast<int>(employees.size()); ++i) {
+        if (i != index && employees[i].getTasks().length() > victimLoad) {
+            victim = i;
+            victimLoad = employees[i].getTasks().length();
+        }
+    }
+    if (victim == -1) {
+        return false;
+    }
+
+    int taskId = (*employees[victim].getTasks().begin()).getId();
+    TaskLocation &location = findTask(taskLocations[stripeOf(taskId)], taskId)->second;
+    TaskQueue::ConstIterator stolen = employees[index].assignTask(Task(*location.m_task));
+    const Task &task = *stolen;
+    SortedList<IndexedTask> &bucket = tasksByType[static_cast<int>(task.getType())];
+    SortedList<IndexedTask>::ConstIterator entry = bucket.end();
+    try {
+        entry = bucket.insert(IndexedTask{task.getPriority(), task.getId(), index, stolen});
+    } catch (...) {
+        employees[index].removeTask(stolen);
+        throw;
+    }
+    bucket.remove(location.m_typeEntry);
+    employees[victim].removeTask(location.m_task);
+    location = TaskLocation{index, stolen, entry};
+    return true;
+}
+
+bool TaskManager::stealTask(std::string_view personName) {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    int index = findPersonIndex(personName);
+    if (index == -1) {
+        return false;
+    }
+    return stealTaskFor(index);
+}
+
+void TaskManager::setWorkStealing(bool stealing) {
+    workStealing = stealing;
+}
+
+int TaskManager::getTaskCount(std::string_view personName) const {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    int index = findPersonIndex(personName);
+    if (index == -1) {
+        return 0;
+    }
+    return employees[index].getTasks().length();
+}
+
+void TaskManager::completeTaskById(int taskId) {
+    std::shared_lock<std::shared_mutex> structure = shareStructure();
+    int stripe = stripeOf(taskId);
+    std::unique_lock<std::mutex> locationLock = lockIfConcurrent(locationMutexes[stripe]);
+    TaskLocationMap::iterator location = findTask(taskLocations[stripe], taskId);
+    std::unique_lock<std::mutex> personLock = lockIfConcurrent(employeeMutexes[location->second.m_personIndex]);
+    removeTask(taskLocations[stripe], location);
+}
+
+void TaskManager::cancelTaskById(int taskId) {
+    completeTaskById(taskId);
+}
+
+void TaskManager::setPriorityById(int taskId, int priority) {
+    std::shared_lock<std::shared_mutex> structure = shareStructure();
+    int stripe = stripeOf(taskId);
+    std::unique_lock<std::mutex> locationLock = lockIfConcurrent(locationMutexes[stripe]);
+    TaskLocation &task = findTask(taskLocations[stripe], taskId)->second;
+    std::unique_lock<std::mutex> personLock = lockIfConcurrent(employeeMutexes[task.m_personIndex]);
+    employees[task.m_personIndex].setTaskPriority(task.m_task, priority);
+    int newPriority = (*task.m_task).getPriority();
+    int type = static_cast<int>((*task.m_task).getType());
+    std::unique_lock<std::mutex> typeLock = lockIfConcurrent(typeMutexes[type]);
+    tasksByType[type].update(task.m_typeEntry, [newPriority](IndexedTask &entry) {
+        entry.m_priority = newPriority;
+    });
+}
+
+void TaskManager::saveSnapshot(std::ostream &out) const {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+
+    std::unordered_map<std::string_view, std::uint32_t> stringIndexes;
+    std::vector<std::string_view> strings;
+    auto stringIndex = [&stringIndexes, &strings](std::string_view text) {
+        auto added = stringIndexes.emplace(text, static_cast<std::uint32_t>(strings.size()));
+        if (added.second) {
+            strings.push_back(text);
+        }
+        return added.first->second;
+    };
+
+    std::vector<SnapshotPerson> persons;
+    std::vector<SnapshotTask> tasks;
+    std::size_t taskCount = 0;
+    for (const SortedList<IndexedTask> &bucket : tasksByType) {
+        taskCount += static_cast<std::size_t>(bucket.length());
+    }
+    persons.reserve(employees.size());
+    tasks.reserve(taskCount);
+    std::vector<std::uint32_t> runStarts(employees.size() * TASK_TYPE_COUNT + 1, 0);
+    for (const Person &employee : employees) {
+        const TaskQueue &queue = employee.getTasks();
+        std::uint32_t *runs = &runStarts[persons.size() * TASK_TYPE_COUNT + 1];
+        persons.push_back(SnapshotPerson{stringIndex(employee.getName()), static_cast<std::uint32_t>(queue.length()),
+                                         tasks.size()});
+        for (const Task &task : queue) {
+            runs[static_cast<int>(task.getType())]++;
+            tasks.push_back(SnapshotTask{task.getId(), stringIndex(task.getDescription()),
+                                         static_cast<std::uint8_t>(task.getPriority()),
+                                         static_cast<std::uint8_t>(task.getType()), 0});
+        }
+    }
+
+    // A type index holds each employee's tasks of the type in list order, so the task of an
+    // entry is the next one of its owner and type. Group the tasks by owner and type to find it.
+    for (std::size_t run = 1; run < runStarts.size(); ++run) {
+        runStarts[run] += runStarts[run - 1];
+    }
+    std::vector<std::uint32_t> byOwnerAndType(tasks.size());
+    std::vector<std::uint32_t> runEnds(runStarts.begin(), runStarts.end() - 1);
+    for (std::size_t index = 0; index < persons.size(); ++index) {
+        const SnapshotPerson &person = persons[index];
+        for (std::uint64_t record = person.m_firstTask; record < person.m_firstTask + person.m_taskCount; ++record) {
+            byOwnerAndType[runEnds[index * TASK_TYPE_COUNT + tasks[record].m_type]++] = static_cast<std::uint32_t>(record);
+        }
+    }
+
+    std::uint64_t typeCounts[TASK_TYPE_COUNT];
+    std::vector<std::uint32_t> typeIndexes;
+    typeIndexes.reserve(tasks.size());
+    for (int type = 0; type < TASK_TYPE_COUNT; ++type) {
+        typeCounts[type] = static_cast<std::uint64_t>(tasksByType[type].length());
+        for (const IndexedTask &entry : tasksByType[type]) {
+            typeIndexes.push_back(byOwnerAndType[runStarts[entry.m_personIndex * TASK_TYPE_COUNT + type]++]);
+        }
+    }
+
+    std::vector<std::uint64_t> stringOffsets;
+    stringOffsets.reserve(strings.size() + 1);
+    stringOffsets.push_back(0);
+    for (std::string_view text : strings) {
+        stringOffsets.push_back(stringOffsets.back() + text.size());
+    }
+
+    SnapshotHeader header;
+    std::memcpy(header.m_magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.m_version = SNAPSHOT_VERSION;
+    header.m_byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.m_nextTaskId = currentTaskId.load();
+    header.m_personCount = static_cast<std::uint32_t>(persons.size());
+    header.m_typeCount = TASK_TYPE_COUNT;
+    header.m_stringCount = static_cast<std::uint32_t>(strings.size());
+    header.m_taskCount = tasks.size();
+    header.m_stringBytes = stringOffsets.back();
+    SnapshotLayout layout = getSnapshotLayout(header);
+
+    std::uint64_t position = 0;
+    writeSection(out, position, 0, &header, sizeof(header));
+    writeSection(out, position, layout.m_persons, persons.data(), persons.size() * sizeof(SnapshotPerson));
+    writeSection(out, position, layout.m_tasks, tasks.data(), tasks.size() * sizeof(SnapshotTask));
+    writeSection(out, position, layout.m_typeCounts, typeCounts, sizeof(typeCounts));
+    writeSection(out, position, layout.m_typeIndexes, typeIndexes.data(), typeIndexes.size() * sizeof(std::uint32_t));
+    writeSection(out, position, layout.m_stringOffsets, stringOffsets.data(),
+                 stringOffsets.size() * sizeof(std::uint64_t));
+    for (std::string_view text : strings) {
+        writeSection(out, position, position, text.data(), text.size());
+    }
+}
+
+void TaskManager::saveSnapshot(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open snapshot file for writing.");
+    }
+    saveSnapshot(out);
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write snapshot.");
+    }
+}
+
+void TaskManager::loadSnapshot(std::istream &in) {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    if (!employees.empty()) {
+        throw std::runtime_error("A snapshot can only be loaded into a TaskManager without employees.");
+    }
+    try {
+        loadSnapshotContents(in);
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+void TaskManager::loadSnapshot(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open snapshot file for reading.");
+    }
+    loadSnapshot(in);
+}
+
+/*
+ * Every list is rebuilt in its saved order: each employee's tasks arrive in list order, which
+ * TaskQueue places in O(1), and each type index is bulk inserted in list order, which
+ * SortedList links in one pass. Tasks are entered in the ID map last, once their type index
+ * entries exist.
+ */
+void TaskManager::loadSnapshotContents(std::istream &in) {
+    std::uint64_t position = 0;
+    SnapshotHeader header;
+    readSection(in, position, 0, &header, sizeof(header));
+    checkSnapshotHeader(header);
+    checkSnapshot(header.m_typeCount == TASK_TYPE_COUNT);
+    SnapshotLayout layout = getSnapshotLayout(header);
+
+    std::vector<SnapshotPerson> persons;
+    readArray(in, position, layout.m_persons, persons, header.m_personCount);
+    std::vector<SnapshotTask> tasks;
+    readArray(in, position, layout.m_tasks, tasks, header.m_taskCount);
+    std::uint64_t typeCounts[TASK_TYPE_COUNT];
+    readSection(in, position, layout.m_typeCounts, typeCounts, sizeof(typeCounts));
+    std::vector<std::uint32_t> typeIndexes;
+    readArray(in, position, layout.m_typeIndexes, typeIndexes, header.m_taskCount);
+    std::vector<std::uint64_t> stringOffsets;
+    readArray(in, position, layout.m_stringOffsets, stringOffsets, std::uint64_t(header.m_stringCount) + 1);
+    std::vector<char> stringBytes;
+    readArray(in, position, layout.m_strings, stringBytes, header.m_stringBytes);
+
+    checkSnapshot(stringOffsets.front() == 0 && stringOffsets.back() == header.m_stringBytes);
+    std::vector<std::string_view> strings(header.m_stringCount);
+    for (std::size_t i = 0; i < strings.size(); ++i) {
+        checkSnapshot(stringOffsets[i] <= stringOffsets[i + 1]);
+        strings[i] = std::string_view(stringBytes.data() + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]);
+    }
+    std::vector<StringPool::Handle> handles(strings.size()); // Interned descriptions, made on first use
+    auto internedString = [this, &strings, &handles](std::uint32_t index) {
+        if (!handles[index] && !strings[index].empty()) {
+            handles[index] = descriptions.intern(strings[index]);
+        }
+        return handles[index];
+    };
+
+    std::vector<TaskQueue::ConstIterator> nodes;
+    std::vector<int> owners;
+    nodes.reserve(tasks.size());
+    owners.reserve(tasks.size());
+    for (const SnapshotPerson &person : persons) {
+        checkSnapshot(person.m_name < strings.size() && person.m_firstTask == nodes.size() &&
+                      person.m_taskCount <= tasks.size() - nodes.size());
+        checkSnapshot(findPersonIndex(strings[person.m_name]) == -1);
+        int index = addPerson(strings[person.m_name]);
+        for (std::uint32_t i = 0; i < person.m_taskCount; ++i) {
+            const SnapshotTask &record = tasks[nodes.size()];
+            checkSnapshot(record.m_id >= 0 && record.m_id < header.m_nextTaskId && record.m_priority <= 100 &&
+                          record.m_type < TASK_TYPE_COUNT && record.m_description < strings.size());
+            TaskType type = static_cast<TaskType>(record.m_type);
+            Task task = internDescriptions ? Task(record.m_priority, type, internedString(record.m_description))
+                                           : Task(record.m_priority, type, std::string(strings[record.m_description]));
+            task.setId(record.m_id);
+            nodes.push_back(employees[index].assignTask(std::move(task)));
+            owners.push_back(index);
+        }
+    }
+    checkSnapshot(nodes.size() == tasks.size());
+
+    std::vector<bool> indexed(tasks.size(), false);
+    std::size_t next = 0;
+    for (int type = 0; type < TASK_TYPE_COUNT; ++type) {
+        checkSnapshot(typeCounts[type] <= typeIndexes.size() - next);
+        std::vector<IndexedTask> entries;
+        entries.reserve(typeCounts[type]);
+        for (std::uint64_t i = 0; i < typeCounts[type]; ++i, ++next) {
+            std::uint32_t record = typeIndexes[next];
+            checkSnapshot(record < tasks.size() && !indexed[record] && tasks[record].m_type == type);
+            indexed[record] = true;
+            entries.push_back(IndexedTask{tasks[record].m_priority, tasks[record].m_id, owners[record], nodes[record]});
+        }
+        SortedList<IndexedTask> &bucket = tasksByType[type];
+        bucket.insert(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+        for (SortedList<IndexedTask>::ConstIterator entry = bucket.begin(); entry != bucket.end(); ++entry) {
+            const IndexedTask &task = *entry;
+            bool added = taskLocations[stripeOf(task.m_id)].emplace(task.m_id,
+                    TaskLocation{task.m_personIndex, task.m_task, entry}).second;
+            checkSnapshot(added);
+        }
+    }
+    checkSnapshot(next == tasks.size());
+
+    currentTaskId = header.m_nextTaskId;
+    if (internDescriptions) {
+        descriptionsPurgeSize = std::max(MIN_DESCRIPTIONS_PURGE_SIZE, 2 * descriptions.size());
+    }
+}
+
+// The caller holds the structure to itself.
+void TaskManager::clear() {
+    for (TaskLocationMap &locations : taskLocations) {
+        locations.clear();
+    }
+    for (SortedList<IndexedTask> &bucket : tasksByType) {
+        bucket = SortedList<IndexedTask>();
+    }
+    employeeIndex.clear();
+    employees.clear();
+    employeeMutexes.clear();
+    currentTaskId = 0;
+}
+
+void TaskManager::printAllEmployees() const {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    for (const Person &employee : employees) {
+        std::cout << employee << std::endl;
+    }
+}
+
+void TaskManager::printTasksByType(TaskType type) const {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    const SortedList<IndexedTask> &bucket = tasksByType[static_cast<int>(type)];
+    for (typename SortedList<IndexedTask>::ConstIterator it = bucket.begin(); it != bucket.end(); ++it) {
+        std::cout << *(*it).m_task << std::endl;
+    }
+}
+
+void TaskManager::printAllTasks() const {
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+    std::vector<const TaskQueue *> lists;
+    lists.reserve(employees.size());
+    for (const Person &employee : employees) {
+        lists.push_back(&employee.getTasks());
+    }
+    mtm::forEachMerged(lists, [](const Task &task) {
+        std::cout << task << '\n';
+    });
+    std::cout.flush();
+}
+
+void TaskManager::bumpPriorityByType(TaskType type, int amount) {
+    if (amount < 0)
+        return;
+
+    std::unique_lock<std::shared_mutex> structure = lockStructure();
+
+    // the bucket is in list order, so a stable sort by owner keeps every person's share in list order
+    SortedList<IndexedTask> &bucket = tasksByType[static_cast<int>(type)];
+    std::vector<std::pair<int, TaskQueue::ConstIterator>> owned;
+    owned.reserve(bucket.length());
+    for (const IndexedTask &entry : bucket) {
+        owned.emplace_back(entry.m_personIndex, entry.m_task);
+    }
+    std::stable_sort(owned.begin(), owned.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    std::vector<TaskQueue::ConstIterator> tasks;
+    tasks.reserve(owned.size());
+    for (std::size_t first = 0; first < owned.size();) {
+        std::size_t last = first;
+        tasks.clear();
+        while (last < owned.size() && owned[last].first == owned[first].first) {
+            tasks.push_back(owned[last].second);
+            last++;
+        }
+        employees[owned[first].first].bumpTaskPriorities(tasks, amount);
+        first = last;
+    }
+
+    // every entry of the bucket moves as well
+    bucket.update_if([](const IndexedTask &) {
+        return true;
+    }, [](IndexedTask &entry) {
+        entry.m_priority = (*entry.m_task).getPriority();
+    });
+}
@@ -2,27 +2,105 @@
 
 #include "Task.h"
 #include "Person.h"
+#include "StringPool.h"
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 /**
  * @brief Class managing tasks assigned to multiple persons.
+ *
+ * In concurrent mode every member function may be called from several threads at once.
+ * Operations on one task lock the task's slot of the ID map, its owner and its type
+ * index, in that order, so tasks of different employees are changed in parallel.
+ * Adding an employee, batches, stealing, bumping a whole type, snapshots and printing lock
+ * out every other operation, so prints show a consistent state.
  */
 class TaskManager {
 private:
-    static const int MAX_PERSONS = 10;
-    Person employees[MAX_PERSONS]; // Use a fixed-size array
-    int currentTaskId = 0;
-    int personCount = 0; // Initialize personCount
+    static const int TASK_TYPE_COUNT = static_cast<int>(TaskType::General) + 1;
+    static const int LOCATION_STRIPES = 64;
 
-    int getcurrentTaskID() const {
-        return currentTaskId;
-    }
+    /**
+     * @brief Entry of the per-type index: the sort key of a task and where it lives.
+     */
+    struct IndexedTask {
+        int m_priority;
+        int m_id;
+        int m_personIndex;
+        TaskQueue::ConstIterator m_task;
+
+        bool operator>(const IndexedTask &other) const {
+            if (m_priority == other.m_priority) {
+                return m_id < other.m_id;
+            }
+            return m_priority > other.m_priority;
+        }
+    };
+
+    /**
+     * @brief Where a task lives: its owner, its node and its per-type index entry.
+     */
+    struct TaskLocation {
+        int m_personIndex;
+        TaskQueue::ConstIterator m_task;
+        SortedList<IndexedTask>::ConstIterator m_typeEntry;
+    };
+
+    using TaskLocationMap = std::unordered_map<int, TaskLocation>;
+
+    std::deque<Person> employees; // Never moves a Person, so iterators into their lists stay valid
+    std::unordered_map<std::string_view, int> employeeIndex; // Keys view the names stored in employees
+    std::atomic<int> currentTaskId;
+    SortedList<IndexedTask> tasksByType[TASK_TYPE_COUNT]; // Same order as the employees' lists
+    TaskLocationMap taskLocations[LOCATION_STRIPES]; // By task ID, striped by ID
+    bool internDescriptions = false;
+    StringPool descriptions; // Shared descriptions when internDescriptions is set
+    std::size_t descriptionsPurgeSize = 0; // Pool size at which unused descriptions are dropped
+    bool workStealing = false; // completeTask on a person without tasks steals one first
+
+    bool concurrent = false; // The locks below are only taken in concurrent mode
+    mutable std::shared_mutex structureMutex; // Exclusive to add an employee or to see all of them at once
+    std::deque<std::mutex> employeeMutexes; // Same indexes as employees
+    std::mutex typeMutexes[TASK_TYPE_COUNT];
+    std::mutex locationMutexes[LOCATION_STRIPES];
+    std::mutex descriptionsMutex;
+
+    int findPersonIndex(std::string_view personName) const;
+
+    int addPerson(std::string_view personName);
+
+    static int stripeOf(int taskId);
 
-    void setcurrentTaskID() {
-        currentTaskId++;
-    }
+    TaskLocationMap::iterator findTask(TaskLocationMap &locations, int taskId);
 
-    int findPersonIndex(const std::string &personName) const;
+    void placeTask(int index, Task &&task);
+
+    void removeTask(TaskLocationMap &locations, TaskLocationMap::iterator location);
+
+    void removeHighestPriorityTask(int index);
+
+    bool stealTaskFor(int index);
+
+    void internDescription(Task &task);
+
+    void loadSnapshotContents(std::istream &in);
+
+    void clear();
+
+    std::unique_lock<std::mutex> lockIfConcurrent(std::mutex &mutex);
+
+    std::shared_lock<std::shared_mutex> shareStructure() const;
+
+    std::unique_lock<std::shared_mutex> lockStructure() const;
 
 public:
     /**
@@ -30,6 +108,21 @@ public:
      */
     TaskManager();
 
+    /**
+     * @brief Constructor to create a TaskManager object that can share equal descriptions.
+     *
+     * @param intern Whether tasks with equal descriptions keep a single copy of it.
+     */
+    explicit TaskManager(bool intern);
+
+    /**
+     * @brief Constructor to create a TaskManager object that can be used from several threads.
+     *
+     * @param intern Whether tasks with equal descriptions keep a single copy of it.
+     * @param concurrent Whether member functions may be called concurrently.
+     */
+    TaskManager(bool intern, bool concurrent);
+
     /**
      * @brief Deleted copy constructor to prevent copying of TaskManager objects.
      */
@@ -46,14 +139,97 @@ public:
      * @param personName The name of the person to whom the task will be assigned.
      * @param task The task to be assigned.
      */
-    void assignTask(const std::string &personName, const Task &task);
+    void assignTask(std::string_view personName, const Task &task);
+
+    /**
+     * @brief Assigns a task to a person, moving its description instead of copying it.
+     *
+     * @param personName The name of the person to whom the task will be assigned.
+     * @param task The task to be assigned.
+     */
+    void assignTask(std::string_view personName, Task &&task);
+
+    /**
+     * @brief Assigns a batch of tasks, giving them consecutive IDs in batch order.
+     *
+     * Each name is looked up once and the batch is applied under a single lock, so no other
+     * thread sees it half done. If an assignment throws, the tasks before it stay assigned.
+     *
+     * @param tasks Pairs of a person's name and the task assigned to them.
+     */
+    void assignTasks(std::vector<std::pair<std::string, Task>> tasks);
 
     /**
      * @brief Completes the highest priority task assigned to a person.
      *
+     * With work stealing on, a person without tasks first steals one as stealTask() does.
+     *
      * @param personName The name of the person who will complete the task.
+     * @throws std::runtime_error If the person has no task and could not steal one.
+     */
+    void completeTask(std::string_view personName);
+
+    /**
+     * @brief Completes the highest priority tasks assigned to a person, one after the other.
+     *
+     * @param personName The name of the person who will complete the tasks.
+     * @param count The number of tasks to complete.
+     * @return int The number of tasks completed, fewer than count if the person runs out.
      */
-    void completeTask(const std::string &personName);
+    int completeTasks(std::string_view personName, int count);
+
+    /**
+     * @brief Completes a task by its ID, whoever it is assigned to.
+     *
+     * @param taskId The ID of the task to be completed.
+     * @throws std::runtime_error If no task has this ID.
+     */
+    void completeTaskById(int taskId);
+
+    /**
+     * @brief Cancels a task by its ID, removing it without completing it.
+     *
+     * @param taskId The ID of the task to be cancelled.
+     * @throws std::runtime_error If no task has this ID.
+     */
+    void cancelTaskById(int taskId);
+
+    /**
+     * @brief Sets the priority of a task by its ID.
+     *
+     * @param taskId The ID of the task.
+     * @param priority The new priority, enforced to be in range [0, 100].
+     * @throws std::runtime_error If no task has this ID.
+     */
+    void setPriorityById(int taskId, int priority);
+
+    /**
+     * @brief Moves the highest priority task of the most loaded employee to a person.
+     *
+     * A task is only taken from an employee left with at least as many tasks as the person.
+     * It keeps its ID and priority, so its place among all tasks does not change.
+     *
+     * @param personName The name of the person who takes the task.
+     * @return bool Whether a task was moved.
+     */
+    bool stealTask(std::string_view personName);
+
+    /**
+     * @brief Turns work stealing by completeTask() on or off.
+     *
+     * Must not be called while other threads use the manager.
+     *
+     * @param stealing Whether a person without tasks steals one before completing it.
+     */
+    void setWorkStealing(bool stealing);
+
+    /**
+     * @brief Gets the number of tasks assigned to a person.
+     *
+     * @param personName The name of the person.
+     * @return int The number of tasks, 0 for an unknown person.
+     */
+    int getTaskCount(std::string_view personName) const;
 
     /**
      * @brief Bumps the priority of all tasks of a specific type.
@@ -63,6 +239,45 @@ public:
      */
     void bumpPriorityByType(TaskType type, int priority);
 
+    /**
+     * @brief Writes every employee, task and the next task ID as a binary snapshot.
+     *
+     * The layout is described in TaskSnapshot.h. Each description is stored once.
+     *
+     * @param out The stream to write to, opened in binary mode.
+     * @throws std::runtime_error If writing fails.
+     */
+    void saveSnapshot(std::ostream &out) const;
+
+    /**
+     * @brief Writes a binary snapshot to a file, replacing it.
+     *
+     * @param path The path of the file.
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void saveSnapshot(const std::string &path) const;
+
+    /**
+     * @brief Loads a snapshot written by saveSnapshot in time linear in its size.
+     *
+     * The tasks keep their IDs, lists and type order, and new tasks continue from the saved
+     * next ID. Equal descriptions share one copy, in the description pool when descriptions
+     * are interned.
+     *
+     * @param in The stream to read from, opened in binary mode.
+     * @throws std::runtime_error If the manager already has employees or the snapshot is
+     *         malformed, in which case the manager is left without employees.
+     */
+    void loadSnapshot(std::istream &in);
+
+    /**
+     * @brief Loads a snapshot from a file.
+     *
+     * @param path The path of the file.
+     * @throws std::runtime_error If the file cannot be read or loadSnapshot(std::istream &) fails.
+     */
+    void loadSnapshot(const std::string &path);
+
     /**
      * @brief Prints all employees and their tasks.
      */
@@ -0,0 +1,257 @@
+#include "TaskQueue.h"
+#include <utility>
+
+namespace {
+    int lowestSetBit(std::uint64_t word) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(word);
+#else
+        int bit = 0;
+        while ((word & 1) == 0) {
+            word >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+}
+
+TaskQueue::TaskQueue() : m_head(nullptr), m_end(nullptr), m_length(0), m_buckets(), m_nonEmpty() {
+}
+
+// The source is already in list order, so every copy lands at the end of the chain.
+TaskQueue::TaskQueue(const TaskQueue& other) : TaskQueue() {
+    for (Node *current = other.m_head; current != nullptr; current = current->m_next) {
+        attachNode(new Node{current->m_task, nullptr, nullptr}, false);
+    }
+}
+
+TaskQueue::TaskQueue(TaskQueue&& other) noexcept : TaskQueue() {
+    swapContents(other);
+}
+
+TaskQueue& TaskQueue::operator=(const TaskQueue& other) {
+    if (this != &other) {
+        TaskQueue copy(other);
+        swapContents(copy);
+    }
+    return *this;
+}
+
+TaskQueue& TaskQueue::operator=(TaskQueue&& other) noexcept {
+    if (this != &other) {
+        deleteAllNodes();
+        swapContents(other);
+    }
+    return *this;
+}
+
+TaskQueue::~TaskQueue() {
+    deleteAllNodes();
+}
+
+TaskQueue::ConstIterator TaskQueue::insert(const Task& task) {
+    Node *node = new Node{task, nullptr, nullptr};
+    attachNode(node, true);
+    return ConstIterator(this, node);
+}
+
+TaskQueue::ConstIterator TaskQueue::insert(Task&& task) {
+    Node *node = new Node{std::move(task), nullptr, nullptr};
+    attachNode(node, true);
+    return ConstIterator(this, node);
+}
+
+void TaskQueue::remove(const ConstIterator& iterator) {
+    if (iterator.m_node == nullptr || iterator.m_queue != this) {
+        return;
+    }
+    detachNode(iterator.m_node);
+    delete iterator.m_node;
+}
+
+int TaskQueue::length() const {
+    return m_length;
+}
+
+TaskQueue::ConstIterator TaskQueue::begin() const {
+    return ConstIterator(this, m_head);
+}
+
+TaskQueue::ConstIterator TaskQueue::end() const {
+    return ConstIterator(this, nullptr);
+}
+
+// Returns the last task of the nearest non-empty bucket above priority, or null if there is none.
+TaskQueue::Node *TaskQueue::lastAbove(int priority) const noexcept {
+    int first = priority + 1;
+    for (int word = first / 64; word < BITMAP_WORDS; ++word) {
+        std::uint64_t bits = m_nonEmpty[word];
+        if (word == first / 64) {
+            bits &= ~std::uint64_t(0) << (first % 64);
+        }
+        if (bits != 0) {
+            return m_buckets[word * 64 + lowestSetBit(bits)].m_last;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ * Links a detached node into the bucket of its priority. Within a bucket the node is
+ * placed by walking from hint, a task of the same bucket, or else from the bucket's
+ * last task, which is already the right place for a task with a new highest ID.
+ * beforeEqual selects whether it goes in front of equal tasks.
+ */
+void TaskQueue::attachNode(Node *node, bool beforeEqual, Node *hint) noexcept {
+    int priority = node->m_task.getPriority();
+    Bucket &bucket = m_buckets[priority];
+    Node *previous;
+    if (bucket.m_first == nullptr) {
+        previous = lastAbove(priority);
+        bucket.m_first = node;
+        bucket.m_last = node;
+        m_nonEmpty[priority / 64] |= std::uint64_t(1) << (priority % 64);
+    } else {
+        int id = node->m_task.getId();
+        auto comesBefore = [id, beforeEqual](const Node *other) {
+            return other->m_task.getId() < id || (!beforeEqual && other->m_task.getId() == id);
+        };
+        Node *stop = bucket.m_first->m_prev;
+        Node *end = bucket.m_last->m_next;
+        Node *start = (hint != nullptr) ? hint : bucket.m_last;
+        if (comesBefore(start)) {
+            previous = start;
+            while (previous->m_next != end && comesBefore(previous->m_next)) {
+                previous = previous->m_next;
+            }
+        } else {
+            previous = start->m_prev;
+            while (previous != stop && !comesBefore(previous)) {
+                previous = previous->m_prev;
+            }
+        }
+        if (previous == bucket.m_last) {
+            bucket.m_last = node;
+        }
+        if (previous == stop) {
+            bucket.m_first = node;
+        }
+    }
+
+    node->m_prev = previous;
+    node->m_next = (previous == nullptr) ? m_head : previous->m_next;
+    if (previous == nullptr) {
+        m_head = node;
+    } else {
+        previous->m_next = node;
+    }
+    if (node->m_next == nullptr) {
+        m_end = node;
+    } else {
+        node->m_next->m_prev = node;
+    }
+    m_length++;
+}
+
+void TaskQueue::detachNode(Node *node) noexcept {
+    int priority = node->m_task.getPriority();
+    Bucket &bucket = m_buckets[priority];
+    if (bucket.m_first == node && bucket.m_last == node) {
+        bucket.m_first = nullptr;
+        bucket.m_last = nullptr;
+        m_nonEmpty[priority / 64] &= ~(std::uint64_t(1) << (priority % 64));
+    } else if (bucket.m_first == node) {
+        bucket.m_first = node->m_next;
+    } else if (bucket.m_last == node) {
+        bucket.m_last = node->m_prev;
+    }
+
+    if (node->m_prev == nullptr) {
+        m_head = node->m_next;
+    } else {
+        node->m_prev->m_next = node->m_next;
+    }
+    if (node->m_next == nullptr) {
+        m_end = node->m_prev;
+    } else {
+        node->m_next->m_prev = node->m_prev;
+    }
+    m_length--;
+}
+
+/*
+ * Attaches every node of a queue linked through m_next, in queue order. Each node is
+ * placed by walking from the previous node attached to the same bucket, or from the
+ * bucket's first task, so a queue in list order costs one pass over every bucket it
+ * lands in.
+ */
+void TaskQueue::attachAll(Node *queue) noexcept {
+    Node *lastAttached[PRIORITY_COUNT] = {};
+    while (queue != nullptr) {
+        Node *next = queue->m_next;
+        int priority = queue->m_task.getPriority();
+        Node *hint = (lastAttached[priority] != nullptr) ? lastAttached[priority] : m_buckets[priority].m_first;
+        attachNode(queue, false, hint);
+        lastAttached[priority] = queue;
+        queue = next;
+    }
+}
+
+void TaskQueue::deleteAllNodes() noexcept {
+    Node *current = m_head;
+    while (current != nullptr) {
+        Node *next = current->m_next;
+        delete current;
+        current = next;
+    }
+    m_head = nullptr;
+    m_end = nullptr;
+    m_length = 0;
+    for (Bucket &bucket : m_buckets) {
+        bucket = Bucket{nullptr, nullptr};
+    }
+    for (std::uint64_t &word : m_nonEmpty) {
+        word = 0;
+    }
+}
+
+void TaskQueue::swapContents(TaskQueue& other) noexcept {
+    std::swap(m_head, other.m_head);
+    std::swap(m_end, other.m_end);
+    std::swap(m_length, other.m_length);
+    std::swap(m_buckets, other.m_buckets);
+    std::swap(m_nonEmpty, other.m_nonEmpty);
+}
+
+TaskQueue::ConstIterator::ConstIterator(const TaskQueue *queue, Node *node) : m_queue(queue), m_node(node) {
+}
+
+const Task& TaskQueue::ConstIterator::operator*() const {
+    if (m_node == nullptr) {
+        throw std::out_of_range("Iterator out of range");
+    }
+    return m_node->m_task;
+}
+
+TaskQueue::ConstIterator& TaskQueue::ConstIterator::operator++() {
+    if (m_node == nullptr) {
+        throw std::out_of_range("Iterator out of range");
+    }
+    m_node = m_node->m_next;
+    return *this;
+}
+
+TaskQueue::ConstIterator TaskQueue::ConstIterator::operator++(int) {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+}
+
+bool TaskQueue::ConstIterator::operator==(const ConstIterator& other) const {
+    return m_node == other.m_node && m_queue == other.m_queue;
+}
+
+bool TaskQueue::ConstIterator::operator!=(const ConstIterator& other) const {
+    return !(*this == other);
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include "Task.h"
+
+/**
+ * @brief Tasks ordered like operator>(Task, Task), kept in one FIFO bucket per priority.
+ *
+ * Tasks are linked in a single chain in list order, from the highest priority down and
+ * by ascending ID within a priority. Each of the 101 priorities remembers the first and
+ * last task of its run in the chain, and a bitmap marks the non-empty ones, so placing a
+ * task never compares it against other priorities. Inserting tasks with increasing IDs,
+ * removing any task and taking the highest priority task are O(1). A task that changes
+ * priority is placed by ID within its new bucket; batch updates do that in one pass per
+ * bucket. Iterators stay valid until the task they point to is removed.
+ */
+class TaskQueue {
+public:
+    class ConstIterator;
+
+    /**
+     * @brief Constructor to create an empty TaskQueue.
+     */
+    TaskQueue();
+
+    /**
+     * @brief Constructor to create a TaskQueue holding copies of the tasks in a range.
+     *
+     * @param first The beginning of the range.
+     * @param last The end of the range.
+     */
+    template<class InputIterator>
+    TaskQueue(InputIterator first, InputIterator last);
+
+    TaskQueue(const TaskQueue& other);
+    TaskQueue(TaskQueue&& other) noexcept;
+    TaskQueue& operator=(const TaskQueue& other);
+    TaskQueue& operator=(TaskQueue&& other) noexcept;
+    ~TaskQueue();
+
+    /**
+     * @brief Inserts a task in front of any equal task.
+     *
+     * @param task The task to be inserted.
+     * @return ConstIterator The position of the inserted task.
+     */
+    ConstIterator insert(const Task& task);
+
+    /**
+     * @brief Inserts a task in front of any equal task, moving it into the queue.
+     *
+     * @param task The task to be inserted.
+     * @return ConstIterator The position of the inserted task.
+     */
+    ConstIterator insert(Task&& task);
+
+    /**
+     * @brief Removes the task an iterator points to. Iterators of other queues are ignored.
+     *
+     * @param iterator The position of the task to be removed.
+     */
+    void remove(const ConstIterator& iterator);
+
+    /**
+     * @brief Changes a task in place and moves it to the bucket of its new priority.
+     *
+     * The iterator stays valid. If operation throws, the task is put back where its
+     * value now belongs.
+     *
+     * @param iterator The position of the task to be changed.
+     * @param operation Called with a reference to the task.
+     */
+    template<class Operation>
+    void update(const ConstIterator& iterator, Operation operation);
+
+    /**
+     * @brief Changes several tasks in place and moves them to the buckets of their new priorities.
+     *
+     * Placing the tasks is linear in the sizes of the buckets they move to when the
+     * range is in list order. If operation throws, every task is put back where its
+     * value now belongs.
+     *
+     * @param first The beginning of a range of iterators to distinct tasks of this queue.
+     * @param last The end of the range.
+     * @param operation Called with a reference to every task in the range.
+     */
+    template<class InputIterator, class Operation>
+    void update(InputIterator first, InputIterator last, Operation operation);
+
+    /**
+     * @brief Changes in place every task for which condition returns true.
+     *
+     * @param condition Selects the tasks to be changed.
+     * @param operation Called with a reference to every selected task.
+     * @return int The number of tasks changed.
+     */
+    template<class Condition, class Operation>
+    int update_if(Condition condition, Operation operation);
+
+    /**
+     * @brief Gets the number of tasks in the queue.
+     *
+     * @return int The number of tasks.
+     */
+    int length() const;
+
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+private:
+    static const int PRIORITY_COUNT = 101;
+    static const int BITMAP_WORDS = (PRIORITY_COUNT + 63) / 64;
+
+    struct Node {
+        Task m_task;
+        Node *m_next;
+        Node *m_prev;
+    };
+
+    struct Bucket {
+        Node *m_first;
+        Node *m_last;
+    };
+
+    Node *m_head;
+    Node *m_end;
+    int m_length;
+    Bucket m_buckets[PRIORITY_COUNT];
+    std::uint64_t m_nonEmpty[BITMAP_WORDS]; // Bit p is set when bucket p holds a task
+
+    Node *lastAbove(int priority) const noexcept;
+    void attachNode(Node *node, bool beforeEqual, Node *hint = nullptr) noexcept;
+    void detachNode(Node *node) noexcept;
+    void attachAll(Node *queue) noexcept;
+    template<class Operation>
+    void updateAll(Node *queue, Operation operation);
+    void deleteAllNodes() noexcept;
+    void swapContents(TaskQueue& other) noexcept;
+};
+
+class TaskQueue::ConstIterator {
+public:
+    ConstIterator(const ConstIterator& other) = default;
+    ConstIterator& operator=(const ConstIterator& other) = default;
+    ~ConstIterator() = default;
+
+    const Task& operator*() const;
+
+    bool operator!=(const ConstIterator& other) const;
+    ConstIterator& operator++();
+    ConstIterator operator++(int);
+    bool operator==(const ConstIterator& other) const;
+
+private:
+    const TaskQueue *m_queue;
+    Node *m_node;
+
+    ConstIterator(const TaskQueue *queue, Node *node);
+    friend class TaskQueue;
+};
+
+template<class InputIterator>
+TaskQueue::TaskQueue(InputIterator first, InputIterator last) : TaskQueue() {
+    for (; first != last; ++first) {
+        insert(*first);
+    }
+}
+
+template<class Operation>
+void TaskQueue::update(const ConstIterator& iterator, Operation operation) {
+    if (iterator.m_node == nullptr || iterator.m_queue != this) {
+        return;
+    }
+    Node *node = iterator.m_node;
+    detachNode(node);
+    try {
+        operation(node->m_task);
+    } catch (...) {
+        attachNode(node, true);
+        throw;
+    }
+    attachNode(node, true);
+}
+
+template<class Condition, class Operation>
+int TaskQueue::update_if(Condition condition, Operation operation) {
+    // detached nodes are queued in list order so that equal tasks keep their order
+    Node *detached = nullptr;
+    Node *detachedLast = nullptr;
+    int updated = 0;
+    Node *current = m_head;
+    while (current != nullptr) {
+        Node *next = current->m_next;
+        if (condition(current->m_task)) {
+            detachNode(current);
+            current->m_next = nullptr;
+            if (detachedLast == nullptr) {
+                detached = current;
+            } else {
+                detachedLast->m_next = current;
+            }
+            detachedLast = current;
+            updated++;
+        }
+        current = next;
+    }
+    updateAll(detached, operation);
+    return updated;
+}
+
+template<class InputIterator, class Operation>
+void TaskQueue::update(InputIterator first, InputIterator last, Operation operation) {
+    Node *detached = nullptr;
+    Node *detachedLast = nullptr;
+    for (; first != last; ++first) {
+        const ConstIterator &iterator = *first;
+        if (iterator.m_node == nullptr || iterator.m_queue != this) {
+            continue;
+        }
+        Node *node = iterator.m_node;
+        detachNode(node);
+        node->m_next = nullptr;
+        if (detachedLast == nullptr) {
+            detached = node;
+        } else {
+            detachedLast->m_next = node;
+        }
+        detachedLast = node;
+    }
+    updateAll(detached, operation);
+}
+
+// Calls operation on every node of a detached queue, then attaches them all.
+template<class Operation>
+void TaskQueue::updateAll(Node *queue, Operation operation) {
+    try {
+        for (Node *node = queue; node != nullptr; node = node->m_next) {
+            operation(node->m_task);
+        }
+    } catch (...) {
+        attachAll(queue);
+        throw;
+    }
+    attachAll(queue);
+}
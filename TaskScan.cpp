@@ -0,0 +1,189 @@
+#include "TaskScan.h"
+#include <atomic>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define TASK_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    // Binary search stops once this many keys are left, 4 cache lines, and the rest is scanned
+    const std::size_t SCAN_WINDOW = 32;
+
+    ScanLevel detectLevel() {
+#ifdef TASK_SCAN_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return ScanLevel::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return ScanLevel::Sse42;
+        }
+#endif
+        return ScanLevel::Scalar;
+    }
+
+    std::atomic<ScanLevel> &currentLevel() {
+        static std::atomic<ScanLevel> level(getSupportedScanLevel());
+        return level;
+    }
+
+    std::size_t firstNotAboveScalar(const std::uint64_t *keys, std::size_t count, std::uint64_t key) {
+        std::size_t i = 0;
+        while (i < count && keys[i] > key) {
+            ++i;
+        }
+        return i;
+    }
+
+    // Scans types[first, count); every store is kept only on a match, which avoids a branch.
+    std::size_t tasksOfTypeScalar(const TaskType *types, std::size_t first, std::size_t count, TaskType type,
+                                  std::uint32_t *positions) {
+        std::size_t found = 0;
+        for (std::size_t i = first; i < count; ++i) {
+            positions[found] = static_cast<std::uint32_t>(i);
+            found += (types[i] == type) ? 1 : 0;
+        }
+        return found;
+    }
+
+#ifdef TASK_SCAN_X86
+    // The vector compares are signed, so both sides get their sign bit flipped first.
+    const long long SIGN_BIT = static_cast<long long>(0x8000000000000000ull);
+
+    /*
+     * The vector kernels count the keys above key instead of stopping at the first one
+     * that is not: in a sorted range the two are equal, and the count has no branch to
+     * mispredict. Keys past the last full vector are only looked at if all were above.
+     */
+    __attribute__((target("sse4.2")))
+    std::size_t firstNotAboveSse42(const std::uint64_t *keys, std::size_t count, std::uint64_t key) {
+        const __m128i sign = _mm_set1_epi64x(SIGN_BIT);
+        const __m128i target = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(key)), sign);
+        __m128i above = _mm_setzero_si128();
+        std::size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m128i current = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i)), sign);
+            above = _mm_sub_epi64(above, _mm_cmpgt_epi64(current, target));
+        }
+        std::size_t total = static_cast<std::size_t>(_mm_cvtsi128_si64(above) + _mm_extract_epi64(above, 1));
+        if (total < i) {
+            return total;
+        }
+        return i + firstNotAboveScalar(keys + i, count - i, key);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t firstNotAboveAvx2(const std::uint64_t *keys, std::size_t count, std::uint64_t key) {
+        const __m256i sign = _mm256_set1_epi64x(SIGN_BIT);
+        const __m256i target = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), sign);
+        __m256i above = _mm256_setzero_si256();
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i current = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i)),
+                                               sign);
+            above = _mm256_sub_epi64(above, _mm256_cmpgt_epi64(current, target));
+        }
+        __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(above), _mm256_extracti128_si256(above, 1));
+        std::size_t total = static_cast<std::size_t>(_mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1));
+        if (total < i) {
+            return total;
+        }
+        return i + firstNotAboveScalar(keys + i, count - i, key);
+    }
+
+    // Writes the index of every set bit of mask, offset by base.
+    std::size_t appendPositions(unsigned int mask, std::size_t base, std::uint32_t *positions) {
+        std::size_t found = 0;
+        while (mask != 0) {
+            positions[found++] = static_cast<std::uint32_t>(base + static_cast<std::size_t>(__builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+        return found;
+    }
+
+    __attribute__((target("sse4.2")))
+    std::size_t tasksOfTypeSse42(const TaskType *types, std::size_t count, TaskType type,
+                                 std::uint32_t *positions) {
+        const auto *bytes = reinterpret_cast<const std::uint8_t *>(types);
+        const __m128i target = _mm_set1_epi8(static_cast<char>(type));
+        std::size_t found = 0;
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+            auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(current, target)));
+            found += appendPositions(mask, i, positions + found);
+        }
+        return found + tasksOfTypeScalar(types, i, count, type, positions + found);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t tasksOfTypeAvx2(const TaskType *types, std::size_t count, TaskType type,
+                                std::uint32_t *positions) {
+        const auto *bytes = reinterpret_cast<const std::uint8_t *>(types);
+        const __m256i target = _mm256_set1_epi8(static_cast<char>(type));
+        std::size_t found = 0;
+        std::size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i));
+            auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(current, target)));
+            found += appendPositions(mask, i, positions + found);
+        }
+        return found + tasksOfTypeScalar(types, i, count, type, positions + found);
+    }
+#endif
+
+} // namespace
+
+ScanLevel getSupportedScanLevel() {
+    static const ScanLevel supported = detectLevel();
+    return supported;
+}
+
+ScanLevel getScanLevel() {
+    return currentLevel().load(std::memory_order_relaxed);
+}
+
+ScanLevel setScanLevel(ScanLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(getSupportedScanLevel())) {
+        level = getSupportedScanLevel();
+    }
+    currentLevel().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+std::size_t scanInsertionPoint(const std::uint64_t *keys, std::size_t count, std::uint64_t key) {
+    std::size_t first = 0;
+    std::size_t last = count;
+    while (last - first > SCAN_WINDOW) {
+        std::size_t half = (last - first) / 2;
+        std::size_t middle = first + half;
+        bool above = keys[middle] > key;
+        first = above ? middle + 1 : first;
+        last = above ? last : middle;
+    }
+    switch (getScanLevel()) {
+#ifdef TASK_SCAN_X86
+        case ScanLevel::Avx2:
+            return first + firstNotAboveAvx2(keys + first, last - first, key);
+        case ScanLevel::Sse42:
+            return first + firstNotAboveSse42(keys + first, last - first, key);
+#endif
+        default:
+            return first + firstNotAboveScalar(keys + first, last - first, key);
+    }
+}
+
+std::size_t scanTasksOfType(const TaskType *types, std::size_t count, TaskType type, std::uint32_t *positions) {
+    switch (getScanLevel()) {
+#ifdef TASK_SCAN_X86
+        case ScanLevel::Avx2:
+            return tasksOfTypeAvx2(types, count, type, positions);
+        case ScanLevel::Sse42:
+            return tasksOfTypeSse42(types, count, type, positions);
+#endif
+        default:
+            return tasksOfTypeScalar(types, 0, count, type, positions);
+    }
+}
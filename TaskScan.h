@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Task.h"
+
+/**
+ * @brief Instruction sets the task scanning kernels can run on.
+ */
+enum class ScanLevel {
+    Scalar,
+    Sse42,
+    Avx2
+};
+
+/**
+ * @brief Gets the best instruction set the current CPU supports.
+ *
+ * @return ScanLevel The level detected when the program started.
+ */
+ScanLevel getSupportedScanLevel();
+
+/**
+ * @brief Gets the instruction set the scanning kernels currently use.
+ *
+ * @return ScanLevel The level in use, the supported level unless it was lowered.
+ */
+ScanLevel getScanLevel();
+
+/**
+ * @brief Chooses the instruction set of the scanning kernels, for tests and benchmarks.
+ *
+ * A level above what the CPU supports is lowered to the supported level.
+ *
+ * @param level The requested level.
+ * @return ScanLevel The level now in use.
+ */
+ScanLevel setScanLevel(ScanLevel level);
+
+/**
+ * @brief Finds where a task goes in a list given as its packed keys.
+ *
+ * The keys are TaskKey values in list order, that is non-increasing. The result is
+ * the number of keys greater than key, which puts the task in front of any equal
+ * task like SortedList::insert. A binary search narrows the range to a few cache
+ * lines, which are then compared several keys per instruction.
+ *
+ * @param keys The keys of the list, in list order.
+ * @param count The number of keys.
+ * @param key The TaskKey of the task to be placed.
+ * @return std::size_t The index the task would be inserted at.
+ */
+std::size_t scanInsertionPoint(const std::uint64_t *keys, std::size_t count, std::uint64_t key);
+
+/**
+ * @brief Finds the positions of the tasks of one type, given the types of a list.
+ *
+ * @param types The type of every task, in list order.
+ * @param count The number of types.
+ * @param type The type to look for.
+ * @param positions Receives the matching indexes in increasing order; must have room for count.
+ * @return std::size_t The number of matches written to positions.
+ */
+std::size_t scanTasksOfType(const TaskType *types, std::size_t count, TaskType type, std::uint32_t *positions);
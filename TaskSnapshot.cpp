@@ -0,0 +1,43 @@
+#include "TaskSnapshot.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+    // Task IDs are ints, so a snapshot never holds more tasks than this
+    const std::uint64_t MAX_TASKS = 0x7fffffff;
+    const std::uint64_t MAX_STRING_BYTES = std::uint64_t(1) << 48;
+
+    std::uint64_t alignSection(std::uint64_t offset) {
+        return (offset + 7) & ~std::uint64_t(7);
+    }
+
+} // namespace
+
+void checkSnapshotHeader(const SnapshotHeader &header) {
+    if (std::memcmp(header.m_magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::runtime_error("Not a task snapshot.");
+    }
+    if (header.m_byteOrder != SNAPSHOT_BYTE_ORDER) {
+        throw std::runtime_error("Snapshot was written with another byte order.");
+    }
+    if (header.m_version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version.");
+    }
+    if (header.m_nextTaskId < 0 || header.m_taskCount > MAX_TASKS || header.m_stringCount == 0xffffffffu ||
+        header.m_stringBytes > MAX_STRING_BYTES) {
+        throw std::runtime_error("Snapshot header is corrupt.");
+    }
+}
+
+SnapshotLayout getSnapshotLayout(const SnapshotHeader &header) {
+    SnapshotLayout layout;
+    layout.m_persons = sizeof(SnapshotHeader);
+    layout.m_tasks = layout.m_persons + sizeof(SnapshotPerson) * std::uint64_t(header.m_personCount);
+    layout.m_typeCounts = alignSection(layout.m_tasks + sizeof(SnapshotTask) * header.m_taskCount);
+    layout.m_typeIndexes = layout.m_typeCounts + sizeof(std::uint64_t) * std::uint64_t(header.m_typeCount);
+    layout.m_stringOffsets = alignSection(layout.m_typeIndexes + sizeof(std::uint32_t) * header.m_taskCount);
+    layout.m_strings = layout.m_stringOffsets + sizeof(std::uint64_t) * (std::uint64_t(header.m_stringCount) + 1);
+    layout.m_end = layout.m_strings + header.m_stringBytes;
+    return layout;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Binary snapshot of a TaskManager, as written by TaskManager::saveSnapshot.
+ *
+ * A SnapshotHeader is followed by five sections, each starting at a multiple of 8 bytes:
+ *   1. one SnapshotPerson per employee, in the order the employees were added;
+ *   2. one SnapshotTask per task, every employee's tasks together and in list order;
+ *   3. the number of tasks of each type, as m_typeCount 64-bit counts, followed by the
+ *      32-bit indexes into section 2 of every type's tasks in the order of the type index;
+ *   4. m_stringCount + 1 64-bit offsets into section 5, string i spanning [offsets[i], offsets[i + 1]);
+ *   5. the bytes of the names and descriptions, each distinct string stored once.
+ * Integers are in the byte order of the machine that wrote the snapshot.
+ */
+
+const char SNAPSHOT_MAGIC[8] = {'T', 'A', 'S', 'K', 'S', 'N', 'A', 'P'};
+const std::uint32_t SNAPSHOT_VERSION = 1;
+const std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief Fixed-size start of a snapshot.
+ */
+struct SnapshotHeader {
+    char m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_byteOrder; // SNAPSHOT_BYTE_ORDER as written by the saving machine
+    std::int32_t m_nextTaskId;
+    std::uint32_t m_personCount;
+    std::uint32_t m_typeCount;
+    std::uint32_t m_stringCount;
+    std::uint64_t m_taskCount;
+    std::uint64_t m_stringBytes;
+};
+
+/**
+ * @brief An employee: their name and where their tasks are in the task section.
+ */
+struct SnapshotPerson {
+    std::uint32_t m_name;
+    std::uint32_t m_taskCount;
+    std::uint64_t m_firstTask;
+};
+
+/**
+ * @brief A task, with its description as an index into the string table.
+ */
+struct SnapshotTask {
+    std::int32_t m_id;
+    std::uint32_t m_description;
+    std::uint8_t m_priority;
+    std::uint8_t m_type;
+    std::uint16_t m_reserved;
+};
+
+static_assert(sizeof(SnapshotHeader) == 48 && sizeof(SnapshotPerson) == 16 && sizeof(SnapshotTask) == 12,
+              "Snapshot records must have no padding");
+
+/**
+ * @brief Byte offsets of the sections of a snapshot, from the start of the snapshot.
+ */
+struct SnapshotLayout {
+    std::uint64_t m_persons;
+    std::uint64_t m_tasks;
+    std::uint64_t m_typeCounts;
+    std::uint64_t m_typeIndexes;
+    std::uint64_t m_stringOffsets;
+    std::uint64_t m_strings;
+    std::uint64_t m_end;
+};
+
+/**
+ * @brief Checks that a header belongs to a snapshot this build can read.
+ *
+ * @param header The header read from the start of a snapshot.
+ * @throws std::runtime_error If the magic, version or byte order differ, or a count is out of range.
+ */
+void checkSnapshotHeader(const SnapshotHeader &header);
+
+/**
+ * @brief Computes where the sections of a snapshot start.
+ *
+ * @param header A header that passed checkSnapshotHeader.
+ * @return SnapshotLayout The offsets of the sections and the total size.
+ */
+SnapshotLayout getSnapshotLayout(const SnapshotHeader &header);
@@ -0,0 +1,95 @@
+#include "ThreadPool.h"
+
+namespace mtm {
+
+    ThreadPool::ThreadPool(unsigned int threads) :
+            m_job(nullptr), m_count(0), m_next(0), m_busy(0), m_batch(0), m_stopping(false) {
+        for (unsigned int i = 1; i < threads; ++i) {
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (std::thread &worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    unsigned int ThreadPool::size() const {
+        return static_cast<unsigned int>(m_workers.size()) + 1;
+    }
+
+    void ThreadPool::run(std::size_t count, const std::function<void(std::size_t)> &job) {
+        if (count == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> batchLock(m_runMutex);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_count = count;
+        m_next = 0;
+        m_busy = static_cast<unsigned int>(m_workers.size());
+        m_error = nullptr;
+        m_batch++;
+        m_wake.notify_all();
+
+        runJobs(lock);
+        m_done.wait(lock, [this]() {
+            return m_busy == 0;
+        });
+        m_job = nullptr;
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        lock.unlock();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    ThreadPool &ThreadPool::shared() {
+        static ThreadPool pool(std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1);
+        return pool;
+    }
+
+    void ThreadPool::workerLoop() {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this, seen]() {
+                return m_stopping || m_batch != seen;
+            });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_batch;
+            runJobs(lock);
+            if (--m_busy == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    // Takes job numbers until the batch runs out; the lock is released while a job runs.
+    void ThreadPool::runJobs(std::unique_lock<std::mutex> &lock) {
+        while (m_next < m_count) {
+            std::size_t index = m_next++;
+            lock.unlock();
+            try {
+                (*m_job)(index);
+            } catch (...) {
+                lock.lock();
+                if (!m_error) {
+                    m_error = std::current_exception();
+                }
+                continue;
+            }
+            lock.lock();
+        }
+    }
+
+} // namespace mtm
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * @brief Fixed set of worker threads that run batches of numbered jobs.
+     *
+     * run() hands out the numbers of a batch to the workers and to the calling thread,
+     * and returns once every job is done. Batches from different threads are run one
+     * after the other. A job must not call run() on its own pool.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @brief Starts a pool in which run() uses threads threads, the caller included.
+         */
+        explicit ThreadPool(unsigned int threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+
+        /**
+         * @brief Gets the number of threads run() uses, the caller included.
+         */
+        unsigned int size() const;
+
+        /**
+         * @brief Calls job(i) for every i in [0, count) and waits for all of them.
+         *
+         * If jobs throw, the remaining numbers are still handed out and the first
+         * exception is rethrown once the batch is done.
+         */
+        void run(std::size_t count, const std::function<void(std::size_t)> &job);
+
+        /**
+         * @brief Gets a pool with one thread per hardware thread, started on first use.
+         */
+        static ThreadPool &shared();
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::mutex m_runMutex; // Held by the thread whose batch is running
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const std::function<void(std::size_t)> *m_job;
+        std::size_t m_count;
+        std::size_t m_next;
+        unsigned int m_busy; // Workers still on the current batch
+        unsigned long m_batch;
+        std::exception_ptr m_error;
+        bool m_stopping;
+
+        void workerLoop();
+        void runJobs(std::unique_lock<std::mutex> &lock);
+    };
+
+} // namespace mtm
@@ -0,0 +1,835 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "SortedList.h"
+
+namespace mtm {
+
+    /**
+     * Sorted list with the interface of SortedList, storing its elements contiguously in
+     * blocks of about 4 KB instead of one node per element. Traversal reads whole cache
+     * lines of elements, and a position is found by a binary search over the blocks and
+     * then inside one block. Ordering, tie rules and the Compare and Alloc parameters are
+     * the same as in SortedList. Every non-empty list allocates at least one full-size
+     * block, however few elements it holds, so this layout pays off for long lists.
+     *
+     * Unlike SortedList, inserting or removing an element moves its neighbours, so every
+     * operation that changes the list invalidates all iterators. Element moves are
+     * assumed not to throw.
+     */
+    template<class T, class Compare = Greater<T>, class Alloc = std::allocator<T>>
+    class UnrolledSortedList {
+    public:
+        class ConstIterator;
+
+        ConstIterator begin() const;
+        ConstIterator end() const;
+
+        UnrolledSortedList();
+        explicit UnrolledSortedList(const Alloc &allocator);
+        explicit UnrolledSortedList(const Compare &compare, const Alloc &allocator = Alloc());
+
+        template<class InputIterator>
+        UnrolledSortedList(InputIterator first, InputIterator last, const Alloc &allocator = Alloc());
+
+        template<class InputIterator>
+        UnrolledSortedList(InputIterator first, InputIterator last, const Compare &compare,
+                           const Alloc &allocator = Alloc());
+
+        UnrolledSortedList(const UnrolledSortedList &other);
+        UnrolledSortedList(UnrolledSortedList &&other) noexcept;
+        UnrolledSortedList &operator=(const UnrolledSortedList &other);
+        UnrolledSortedList &operator=(UnrolledSortedList &&other);
+        ~UnrolledSortedList();
+
+        ConstIterator insert(const T &insert_value);
+        ConstIterator insert(T &&insert_value);
+
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last);
+
+        void merge(UnrolledSortedList &other);
+
+        template<class ListIterator>
+        void merge(ListIterator first, ListIterator last);
+
+        void remove(const ConstIterator &iterator);
+
+        template<class Condition>
+        int erase_if(Condition condition);
+
+        template<class Condition, class Operation>
+        int update_if(Condition condition, Operation operation);
+
+        template<class Operation>
+        void update(const ConstIterator &iterator, Operation operation);
+
+        ConstIterator find(const T &value) const;
+
+        int length() const;
+
+        template<class Condition>
+        UnrolledSortedList filter(Condition condition) const;
+
+        template<class Operation>
+        UnrolledSortedList apply(Operation operation) const;
+
+        bool operator==(const UnrolledSortedList &other) const;
+
+    private:
+        static const int BLOCK_BYTES = 4096;
+        static const int CAPACITY = (sizeof(T) * 8 > BLOCK_BYTES) ? 8 : static_cast<int>(BLOCK_BYTES / sizeof(T));
+
+        struct Block {
+            int m_count;
+            alignas(T) unsigned char m_storage[CAPACITY * sizeof(T)];
+        };
+
+        using AllocTraits = std::allocator_traits<Alloc>;
+        using BlockAllocator = typename AllocTraits::template rebind_alloc<Block>;
+        using BlockTraits = std::allocator_traits<BlockAllocator>;
+
+        BlockAllocator m_blockAllocator;
+        Compare m_compare;
+        std::vector<Block *> m_blocks;
+        int m_length;
+
+        static T *elements(Block *block);
+        static const T *elements(const Block *block);
+
+        Block *createBlock();
+        Block *takeBlock(Block *&spare);
+        void destroyBlock(Block *block) noexcept;
+        void clear() noexcept;
+        void pushBack(const T &value);
+        void insertAt(std::size_t blockIndex, int offset, T &&value, std::size_t &resultBlock, int &resultOffset,
+                      Block *&spare);
+        void eraseAt(std::size_t blockIndex, int offset) noexcept;
+        void lowerPosition(const T &value, std::size_t &blockIndex, int &offset) const;
+        std::vector<Block *> createBlocks(std::size_t total);
+        void rebuild(std::vector<T> &values, const std::vector<char> *skip);
+        void rebuildInto(std::vector<Block *> &blocks, std::vector<T> &values, const std::vector<char> *skip);
+        void sortWithin(std::vector<T> &values, std::vector<T> &scratch) const;
+        void adopt(std::vector<Block *> &blocks, int length) noexcept;
+        ConstIterator insertValue(T &&value, Block *spare = nullptr);
+    };
+
+    template<class T, class Compare, class Alloc>
+    T *UnrolledSortedList<T, Compare, Alloc>::elements(Block *block) {
+        return std::launder(reinterpret_cast<T *>(block->m_storage));
+    }
+
+    template<class T, class Compare, class Alloc>
+    const T *UnrolledSortedList<T, Compare, Alloc>::elements(const Block *block) {
+        return std::launder(reinterpret_cast<const T *>(block->m_storage));
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::Block *UnrolledSortedList<T, Compare, Alloc>::createBlock() {
+        Block *block = BlockTraits::allocate(m_blockAllocator, 1);
+        block->m_count = 0;
+        return block;
+    }
+
+    // Hands out the block set aside in spare, if any, so that the caller cannot fail to allocate.
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::Block *UnrolledSortedList<T, Compare, Alloc>::takeBlock(
+            Block *&spare) {
+        if (spare == nullptr) {
+            return createBlock();
+        }
+        Block *block = spare;
+        spare = nullptr;
+        return block;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::destroyBlock(Block *block) noexcept {
+        T *data = elements(block);
+        for (int i = 0; i < block->m_count; ++i) {
+            data[i].~T();
+        }
+        BlockTraits::deallocate(m_blockAllocator, block, 1);
+    }
+
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::clear() noexcept {
+        for (Block *block : m_blocks) {
+            destroyBlock(block);
+        }
+        m_blocks.clear();
+        m_length = 0;
+    }
+
+    // Appends a value that goes after every element, filling the last block first.
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::pushBack(const T &value) {
+        if (m_blocks.empty() || m_blocks.back()->m_count == CAPACITY) {
+            m_blocks.reserve(m_blocks.size() + 1);
+            m_blocks.push_back(createBlock());
+        }
+        Block *block = m_blocks.back();
+        ::new (static_cast<void *>(elements(block) + block->m_count)) T(value);
+        block->m_count++;
+        m_length++;
+    }
+
+    /*
+     * Finds where value would be inserted: the first element that does not go in front
+     * of it, or end(). Blocks are searched by their last element, then the block itself.
+     */
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::lowerPosition(const T &value, std::size_t &blockIndex,
+                                                              int &offset) const {
+        auto block = std::partition_point(m_blocks.begin(), m_blocks.end(), [this, &value](const Block *current) {
+            return m_compare(elements(current)[current->m_count - 1], value);
+        });
+        blockIndex = static_cast<std::size_t>(block - m_blocks.begin());
+        if (block == m_blocks.end()) {
+            offset = 0;
+            return;
+        }
+        const T *data = elements(*block);
+        offset = static_cast<int>(std::partition_point(data, data + (*block)->m_count, [this, &value](const T &current) {
+            return m_compare(current, value);
+        }) - data);
+    }
+
+    /*
+     * Inserts value in front of position (blockIndex, offset), splitting a full block,
+     * and reports where the value ended up. A new block is taken from spare when one was
+     * set aside, so with a spare block and room for one more in m_blocks nothing throws.
+     */
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::insertAt(std::size_t blockIndex, int offset, T &&value,
+                                                         std::size_t &resultBlock, int &resultOffset,
+                                                         Block *&spare) {
+        if (m_blocks.empty()) {
+            m_blocks.reserve(1);
+            m_blocks.push_back(takeBlock(spare));
+            blockIndex = 0;
+            offset = 0;
+        } else if (blockIndex == m_blocks.size()) {
+            blockIndex--;
+            offset = m_blocks[blockIndex]->m_count;
+        }
+
+        Block *block = m_blocks[blockIndex];
+        if (block->m_count == CAPACITY) {
+            m_blocks.reserve(m_blocks.size() + 1);
+            Block *fresh = takeBlock(spare);
+            if (offset == CAPACITY || offset == 0) {
+                // appending past either end of a full block starts a new one, which keeps ordered input dense
+                std::size_t freshIndex = (offset == 0) ? blockIndex : blockIndex + 1;
+                m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(freshIndex), fresh);
+                blockIndex = freshIndex;
+                offset = 0;
+                block = fresh;
+            } else {
+                int half = CAPACITY / 2;
+                T *data = elements(block);
+                T *freshData = elements(fresh);
+                for (int i = half; i < CAPACITY; ++i) {
+                    ::new (static_cast<void *>(freshData + (i - half))) T(std::move(data[i]));
+                    data[i].~T();
+                }
+                fresh->m_count = CAPACITY - half;
+                block->m_count = half;
+                m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(blockIndex + 1), fresh);
+                if (offset > half) {
+                    blockIndex++;
+                    offset -= half;
+                    block = fresh;
+                }
+            }
+        }
+
+        T *data = elements(block);
+        if (offset == block->m_count) {
+            ::new (static_cast<void *>(data + offset)) T(std::move(value));
+        } else {
+            ::new (static_cast<void *>(data + block->m_count)) T(std::move(data[block->m_count - 1]));
+            std::move_backward(data + offset, data + block->m_count - 1, data + block->m_count);
+            data[offset] = std::move(value);
+        }
+        block->m_count++;
+        m_length++;
+        resultBlock = blockIndex;
+        resultOffset = offset;
+    }
+
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::eraseAt(std::size_t blockIndex, int offset) noexcept {
+        Block *block = m_blocks[blockIndex];
+        T *data = elements(block);
+        std::move(data + offset + 1, data + block->m_count, data + offset);
+        data[block->m_count - 1].~T();
+        block->m_count--;
+        m_length--;
+        if (block->m_count == 0) {
+            destroyBlock(block);
+            m_blocks.erase(m_blocks.begin() + static_cast<std::ptrdiff_t>(blockIndex));
+        }
+    }
+
+    // Takes over a freshly built set of blocks, releasing the current ones.
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::adopt(std::vector<Block *> &blocks, int length) noexcept {
+        clear();
+        m_blocks.swap(blocks);
+        m_length = length;
+    }
+
+    // Allocates enough empty blocks for total elements, releasing them all if one fails.
+    template<class T, class Compare, class Alloc>
+    std::vector<typename UnrolledSortedList<T, Compare, Alloc>::Block *>
+    UnrolledSortedList<T, Compare, Alloc>::createBlocks(std::size_t total) {
+        std::vector<Block *> blocks;
+        try {
+            blocks.reserve((total + CAPACITY - 1) / CAPACITY);
+            for (std::size_t i = 0; i * CAPACITY < total; ++i) {
+                blocks.push_back(createBlock());
+            }
+        } catch (...) {
+            for (Block *block : blocks) {
+                destroyBlock(block);
+            }
+            throw;
+        }
+        return blocks;
+    }
+
+    /*
+     * Replaces the contents with the elements whose flag in skip is not set (all of them
+     * when skip is null), merged in one pass with values, which must already be sorted.
+     * A value goes in front of the elements that compare equal to it. Every block is
+     * allocated before anything moves, so the list is unchanged if that fails.
+     */
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::rebuild(std::vector<T> &values, const std::vector<char> *skip) {
+        std::size_t kept = 0;
+        for (int i = 0; i < m_length; ++i) {
+            kept += (skip == nullptr || !(*skip)[i]) ? 1 : 0;
+        }
+        std::vector<Block *> blocks = createBlocks(kept + values.size());
+        rebuildInto(blocks, values, skip);
+    }
+
+    // The part of rebuild that allocates nothing, filling blocks made by createBlocks.
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::rebuildInto(std::vector<Block *> &blocks, std::vector<T> &values,
+                                                            const std::vector<char> *skip) {
+        std::size_t target = 0;
+        std::size_t total = 0;
+        auto append = [&blocks, &target, &total](T &value) {
+            if (blocks[target]->m_count == CAPACITY) {
+                target++;
+            }
+            Block *block = blocks[target];
+            ::new (static_cast<void *>(elements(block) + block->m_count)) T(std::move(value));
+            block->m_count++;
+            total++;
+        };
+        std::size_t next = 0;
+        int index = 0;
+        for (Block *block : m_blocks) {
+            T *data = elements(block);
+            for (int i = 0; i < block->m_count; ++i, ++index) {
+                if (skip != nullptr && (*skip)[index]) {
+                    continue;
+                }
+                while (next < values.size() && !m_compare(data[i], values[next])) {
+                    append(values[next++]);
+                }
+                append(data[i]);
+            }
+        }
+        while (next < values.size()) {
+            append(values[next++]);
+        }
+        adopt(blocks, static_cast<int>(total));
+    }
+
+    /*
+     * Stable bottom-up merge sort that moves the values back and forth between values and
+     * scratch, after sorting short runs in place. It never allocates, as long as scratch
+     * has room for every value, and values already in order are only checked.
+     */
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::sortWithin(std::vector<T> &values, std::vector<T> &scratch) const {
+        const std::size_t RUN = 16;
+        std::size_t size = values.size();
+        bool sorted = true;
+        for (std::size_t i = 1; i < size && sorted; ++i) {
+            sorted = !m_compare(values[i], values[i - 1]);
+        }
+        if (sorted) {
+            return;
+        }
+        for (std::size_t start = 0; start < size; start += RUN) {
+            auto first = values.begin() + static_cast<std::ptrdiff_t>(start);
+            auto last = values.begin() + static_cast<std::ptrdiff_t>(std::min(start + RUN, size));
+            for (auto current = first + 1; current < last; ++current) {
+                std::rotate(std::upper_bound(first, current, *current, m_compare), current, current + 1);
+            }
+        }
+        for (std::size_t width = RUN; width < size; width *= 2) {
+            scratch.clear();
+            for (std::size_t start = 0; start < size; start += 2 * width) {
+                std::size_t middle = std::min(start + width, size);
+                std::size_t end = std::min(start + 2 * width, size);
+                std::size_t left = start;
+                std::size_t right = middle;
+                while (left < middle && right < end) {
+                    if (m_compare(values[right], values[left])) {
+                        scratch.push_back(std::move(values[right++]));
+                    } else {
+                        scratch.push_back(std::move(values[left++]));
+                    }
+                }
+                for (; left < middle; ++left) {
+                    scratch.push_back(std::move(values[left]));
+                }
+                for (; right < end; ++right) {
+                    scratch.push_back(std::move(values[right]));
+                }
+            }
+            values.swap(scratch);
+        }
+    }
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc>::UnrolledSortedList() : UnrolledSortedList(Compare(), Alloc()) {}
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc>::UnrolledSortedList(const Alloc &allocator) :
+            UnrolledSortedList(Compare(), allocator) {}
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc>::UnrolledSortedList(const Compare &compare, const Alloc &allocator) :
+            m_blockAllocator(allocator), m_compare(compare), m_blocks(), m_length(0) {}
+
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    UnrolledSortedList<T, Compare, Alloc>::UnrolledSortedList(InputIterator first, InputIterator last,
+                                                              const Alloc &allocator) :
+            UnrolledSortedList(first, last, Compare(), allocator) {}
+
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    UnrolledSortedList<T, Compare, Alloc>::UnrolledSortedList(InputIterator first, InputIterator last,
+                                                              const Compare &compare, const Alloc &allocator) :
+            UnrolledSortedList(compare, allocator) {
+        insert(first, last);
+    }
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc>::UnrolledSortedList(const UnrolledSortedList &other) :
+            UnrolledSortedList(other.m_compare,
+                               AllocTraits::select_on_container_copy_construction(Alloc(other.m_blockAllocator))) {
+        for (ConstIterator i = other.begin(); i != other.end(); ++i) {
+            pushBack(*i);
+        }
+    }
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc>::UnrolledSortedList(UnrolledSortedList &&other) noexcept :
+            m_blockAllocator(other.m_blockAllocator), m_compare(other.m_compare), m_blocks(std::move(other.m_blocks)),
+            m_length(other.m_length) {
+        other.m_blocks.clear();
+        other.m_length = 0;
+    }
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc> &UnrolledSortedList<T, Compare, Alloc>::operator=(
+            const UnrolledSortedList &other) {
+        if (this == &other) {
+            return *this;
+        }
+        Alloc allocator = AllocTraits::propagate_on_container_copy_assignment::value ?
+                          Alloc(other.m_blockAllocator) : Alloc(m_blockAllocator);
+        UnrolledSortedList temp(other.m_compare, allocator);
+        for (ConstIterator i = other.begin(); i != other.end(); ++i) {
+            temp.pushBack(*i);
+        }
+        clear();
+        m_blockAllocator = temp.m_blockAllocator;
+        m_compare = temp.m_compare;
+        m_blocks.swap(temp.m_blocks);
+        std::swap(m_length, temp.m_length);
+        return *this;
+    }
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc> &UnrolledSortedList<T, Compare, Alloc>::operator=(
+            UnrolledSortedList &&other) {
+        if (this == &other) {
+            return *this;
+        }
+        // blocks owned by an unrelated allocator cannot be adopted, only copied
+        if (!AllocTraits::propagate_on_container_move_assignment::value &&
+            !(m_blockAllocator == other.m_blockAllocator)) {
+            return *this = static_cast<const UnrolledSortedList &>(other);
+        }
+        clear();
+        if (AllocTraits::propagate_on_container_move_assignment::value) {
+            m_blockAllocator = other.m_blockAllocator;
+        }
+        m_compare = other.m_compare;
+        m_blocks.swap(other.m_blocks);
+        std::swap(m_length, other.m_length);
+        return *this;
+    }
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc>::~UnrolledSortedList() {
+        clear();
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator
+    UnrolledSortedList<T, Compare, Alloc>::insertValue(T &&value, Block *spare) {
+        std::size_t blockIndex;
+        int offset;
+        lowerPosition(value, blockIndex, offset);
+        insertAt(blockIndex, offset, std::move(value), blockIndex, offset, spare);
+        if (spare != nullptr) {
+            destroyBlock(spare);
+        }
+        return ConstIterator(this, blockIndex, offset);
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator
+    UnrolledSortedList<T, Compare, Alloc>::insert(const T &insert_value) {
+        // copied first, as insert_value may be an element that is about to move
+        T value(insert_value);
+        return insertValue(std::move(value));
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator
+    UnrolledSortedList<T, Compare, Alloc>::insert(T &&insert_value) {
+        return insertValue(std::move(insert_value));
+    }
+
+    // Same order as inserting the elements one by one in range order, in one merge pass.
+    template<class T, class Compare, class Alloc>
+    template<class InputIterator>
+    void UnrolledSortedList<T, Compare, Alloc>::insert(InputIterator first, InputIterator last) {
+        std::vector<T> values(first, last);
+        if (values.empty()) {
+            return;
+        }
+        // one-by-one insertion puts later elements in front of equal ones, hence the reverse
+        std::reverse(values.begin(), values.end());
+        std::stable_sort(values.begin(), values.end(), m_compare);
+        rebuild(values, nullptr);
+    }
+
+    // Moves the elements of other into this list; among equal elements this list comes first.
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::merge(UnrolledSortedList &other) {
+        merge(&other, &other + 1);
+    }
+
+    /*
+     * k-way version of merge, writing the merged elements straight into new blocks. Among
+     * equal elements this list comes first, then the others in range order.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class ListIterator>
+    void UnrolledSortedList<T, Compare, Alloc>::merge(ListIterator first, ListIterator last) {
+        std::vector<const UnrolledSortedList *> lists(1, this);
+        std::vector<UnrolledSortedList *> sources;
+        std::size_t total = static_cast<std::size_t>(m_length);
+        for (; first != last; ++first) {
+            UnrolledSortedList &list = *first;
+            if (&list != this && list.m_length > 0) {
+                lists.push_back(&list);
+                sources.push_back(&list);
+                total += static_cast<std::size_t>(list.m_length);
+            }
+        }
+        if (sources.empty()) {
+            return;
+        }
+
+        std::vector<Block *> blocks;
+        try {
+            blocks.reserve((total + CAPACITY - 1) / CAPACITY);
+            for (std::size_t i = 0; i * CAPACITY < total; ++i) {
+                blocks.push_back(createBlock());
+            }
+        } catch (...) {
+            for (Block *block : blocks) {
+                destroyBlock(block);
+            }
+            throw;
+        }
+
+        std::size_t target = 0;
+        forEachMerged(lists, [&blocks, &target](const T &value) {
+            if (blocks[target]->m_count == CAPACITY) {
+                target++;
+            }
+            Block *block = blocks[target];
+            // every source is emptied right after, so its elements can be moved from
+            ::new (static_cast<void *>(elements(block) + block->m_count)) T(std::move(const_cast<T &>(value)));
+            block->m_count++;
+        }, m_compare);
+        for (UnrolledSortedList *source : sources) {
+            source->clear();
+        }
+        adopt(blocks, static_cast<int>(total));
+    }
+
+    template<class T, class Compare, class Alloc>
+    void UnrolledSortedList<T, Compare, Alloc>::remove(const ConstIterator &iterator) {
+        if (iterator.m_list != this || iterator.m_block >= m_blocks.size()) {
+            return;
+        }
+        eraseAt(iterator.m_block, iterator.m_offset);
+    }
+
+    template<class T, class Compare, class Alloc>
+    template<class Condition>
+    int UnrolledSortedList<T, Compare, Alloc>::erase_if(Condition condition) {
+        std::vector<char> skip(static_cast<std::size_t>(m_length), 0);
+        int removed = 0;
+        int index = 0;
+        for (ConstIterator i = begin(); i != end(); ++i, ++index) {
+            if (condition(*i)) {
+                skip[index] = 1;
+                removed++;
+            }
+        }
+        if (removed > 0) {
+            std::vector<T> none;
+            rebuild(none, &skip);
+        }
+        return removed;
+    }
+
+    /*
+     * Changes every element for which condition returns true and puts it back where it
+     * now belongs, in a single rebuild. Changed elements go in front of unchanged equal
+     * ones and keep their order among themselves, as in SortedList. Everything that
+     * allocates, including the sort buffer, is done before the first element is moved out
+     * of its block, so no element can be lost once they are out.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class Condition, class Operation>
+    int UnrolledSortedList<T, Compare, Alloc>::update_if(Condition condition, Operation operation) {
+        std::vector<char> skip(static_cast<std::size_t>(m_length), 0);
+        std::size_t count = 0;
+        int index = 0;
+        for (ConstIterator i = begin(); i != end(); ++i, ++index) {
+            if (condition(*i)) {
+                skip[index] = 1;
+                count++;
+            }
+        }
+        if (count == 0) {
+            return 0;
+        }
+
+        std::vector<T> updated;
+        updated.reserve(count);
+        std::vector<T> scratch;
+        scratch.reserve(count);
+        std::vector<Block *> blocks = createBlocks(static_cast<std::size_t>(m_length));
+        index = 0;
+        for (Block *block : m_blocks) {
+            T *data = elements(block);
+            for (int i = 0; i < block->m_count; ++i, ++index) {
+                if (skip[index]) {
+                    updated.push_back(std::move(data[i]));
+                }
+            }
+        }
+        auto putBack = [this, &updated, &scratch, &blocks, &skip]() {
+            sortWithin(updated, scratch);
+            rebuildInto(blocks, updated, &skip);
+        };
+        try {
+            for (T &value : updated) {
+                operation(value);
+            }
+        } catch (...) {
+            putBack();
+            throw;
+        }
+        putBack();
+        return static_cast<int>(count);
+    }
+
+    /*
+     * Changes one element and moves it to its new position. Iterators are invalidated.
+     * The block and the room in m_blocks a split may need are set aside before the
+     * element is taken out, so it is always put back, even if operation throws.
+     */
+    template<class T, class Compare, class Alloc>
+    template<class Operation>
+    void UnrolledSortedList<T, Compare, Alloc>::update(const ConstIterator &iterator, Operation operation) {
+        if (iterator.m_list != this || iterator.m_block >= m_blocks.size()) {
+            return;
+        }
+        m_blocks.reserve(m_blocks.size() + 1);
+        Block *spare = createBlock();
+        T value(std::move(elements(m_blocks[iterator.m_block])[iterator.m_offset]));
+        eraseAt(iterator.m_block, iterator.m_offset);
+        try {
+            operation(value);
+        } catch (...) {
+            insertValue(std::move(value), spare);
+            throw;
+        }
+        insertValue(std::move(value), spare);
+    }
+
+    // Returns the first element equivalent to value (neither goes in front of the other), or end().
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator
+    UnrolledSortedList<T, Compare, Alloc>::find(const T &value) const {
+        std::size_t blockIndex;
+        int offset;
+        lowerPosition(value, blockIndex, offset);
+        if (blockIndex == m_blocks.size() || m_compare(value, elements(m_blocks[blockIndex])[offset])) {
+            return end();
+        }
+        return ConstIterator(this, blockIndex, offset);
+    }
+
+    template<class T, class Compare, class Alloc>
+    int UnrolledSortedList<T, Compare, Alloc>::length() const {
+        return m_length;
+    }
+
+    template<class T, class Compare, class Alloc>
+    template<class Condition>
+    UnrolledSortedList<T, Compare, Alloc> UnrolledSortedList<T, Compare, Alloc>::filter(Condition condition) const {
+        UnrolledSortedList result(m_compare,
+                                  AllocTraits::select_on_container_copy_construction(Alloc(m_blockAllocator)));
+        for (ConstIterator i = begin(); i != end(); ++i) {
+            if (condition(*i)) {
+                result.pushBack(*i);
+            }
+        }
+        return result;
+    }
+
+    template<class T, class Compare, class Alloc>
+    template<class Operation>
+    UnrolledSortedList<T, Compare, Alloc> UnrolledSortedList<T, Compare, Alloc>::apply(Operation operation) const {
+        std::vector<T> values;
+        values.reserve(static_cast<std::size_t>(m_length));
+        for (ConstIterator i = begin(); i != end(); ++i) {
+            values.push_back(operation(*i));
+        }
+        UnrolledSortedList result(m_compare,
+                                  AllocTraits::select_on_container_copy_construction(Alloc(m_blockAllocator)));
+        result.insert(values.begin(), values.end());
+        return result;
+    }
+
+    template<class T, class Compare, class Alloc>
+    bool UnrolledSortedList<T, Compare, Alloc>::operator==(const UnrolledSortedList &other) const {
+        if (m_length != other.m_length) {
+            return false;
+        }
+        ConstIterator mine = begin();
+        for (ConstIterator theirs = other.begin(); theirs != other.end(); ++theirs, ++mine) {
+            if (*mine != *theirs) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator UnrolledSortedList<T, Compare, Alloc>::begin() const {
+        return ConstIterator(this, 0, 0);
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator UnrolledSortedList<T, Compare, Alloc>::end() const {
+        return ConstIterator(this, m_blocks.size(), 0);
+    }
+
+    template<class T, class Compare, class Alloc>
+    class UnrolledSortedList<T, Compare, Alloc>::ConstIterator {
+    public:
+        ~ConstIterator() = default;
+
+        ConstIterator(const ConstIterator &other) = default;
+        ConstIterator &operator=(const ConstIterator &other) = default;
+
+        const T &operator*() const;
+
+        bool operator!=(const ConstIterator &other) const;
+        ConstIterator &operator++();
+        ConstIterator operator++(int);
+        bool operator==(const ConstIterator &other) const;
+
+    private:
+        const UnrolledSortedList *m_list;
+        std::size_t m_block;
+        int m_offset;
+
+        ConstIterator(const UnrolledSortedList *list, std::size_t block, int offset);
+        friend class UnrolledSortedList;
+    };
+
+    template<class T, class Compare, class Alloc>
+    UnrolledSortedList<T, Compare, Alloc>::ConstIterator::ConstIterator(const UnrolledSortedList *list,
+                                                                        std::size_t block, int offset) :
+            m_list(list), m_block(block), m_offset(offset) {}
+
+    template<class T, class Compare, class Alloc>
+    const T &UnrolledSortedList<T, Compare, Alloc>::ConstIterator::operator*() const {
+        if (m_block >= m_list->m_blocks.size()) {
+            throw std::out_of_range("Iterator out of range");
+        }
+        return elements(m_list->m_blocks[m_block])[m_offset];
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator &
+    UnrolledSortedList<T, Compare, Alloc>::ConstIterator::operator++() {
+        if (m_block >= m_list->m_blocks.size()) {
+            throw std::out_of_range("Iterator out of range");
+        }
+        if (++m_offset == m_list->m_blocks[m_block]->m_count) {
+            m_block++;
+            m_offset = 0;
+        }
+        return *this;
+    }
+
+    template<class T, class Compare, class Alloc>
+    typename UnrolledSortedList<T, Compare, Alloc>::ConstIterator
+    UnrolledSortedList<T, Compare, Alloc>::ConstIterator::operator++(int) {
+        ConstIterator result = *this;
+        ++(*this);
+        return result;
+    }
+
+    template<class T, class Compare, class Alloc>
+    bool UnrolledSortedList<T, Compare, Alloc>::ConstIterator::operator==(const ConstIterator &other) const {
+        return m_block == other.m_block && m_offset == other.m_offset && m_list == other.m_list;
+    }
+
+    template<class T, class Compare, class Alloc>
+    bool UnrolledSortedList<T, Compare, Alloc>::ConstIterator::operator!=(const ConstIterator &other) const {
+        return !(*this == other);
+    }
+
+} // namespace mtm
@@ -0,0 +1,132 @@
+/*
+ * Heap allocations made by the TaskManager hot paths with long task descriptions:
+ * assigning a copied and a moved Task, bumping priorities and printing every task.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_allocations.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp \
+ *       StringPool.cpp PoolAllocator.cpp -o bench_allocations
+ */
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TaskManager.h"
+
+namespace {
+
+    const int EMPLOYEES = 100;
+    const int TASKS = 100000;
+    const int BUMPS = 20;
+    const std::size_t DESCRIPTION_LENGTH = 512;
+
+    std::size_t g_allocations = 0;
+    std::size_t g_bytes = 0;
+
+    struct Counter {
+        std::size_t m_allocations;
+        std::size_t m_bytes;
+
+        Counter() : m_allocations(g_allocations), m_bytes(g_bytes) {
+        }
+
+        void report(const char *name, int operations) const {
+            std::printf("%-28s %12.2f %14.1f\n", name,
+                        static_cast<double>(g_allocations - m_allocations) / operations,
+                        static_cast<double>(g_bytes - m_bytes) / operations);
+        }
+    };
+
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override {
+            return c;
+        }
+
+        std::streamsize xsputn(const char *, std::streamsize count) override {
+            return count;
+        }
+    };
+
+    std::string employeeName(int index) {
+        return "Employee " + std::to_string(index);
+    }
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    ++g_allocations;
+    g_bytes += size;
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+/*
+ * The replaced operator new above hands out malloc'd memory, so std::free is the right
+ * release. GCC only sees the operator new/std::free pairing once the calls are inlined
+ * and flags it with -Wmismatched-new-delete; the warning does not apply here.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+int main() {
+    const std::string description(DESCRIPTION_LENGTH, 'x');
+    std::string names[EMPLOYEES];
+    for (int i = 0; i < EMPLOYEES; ++i) {
+        names[i] = employeeName(i);
+    }
+
+    TaskManager manager;
+    for (int i = 0; i < EMPLOYEES; ++i) {
+        manager.assignTask(names[i], Task(0, TaskType::General, description));
+    }
+
+    std::printf("%-28s %12s %14s\n", "operation", "allocs/op", "bytes/op");
+    const Task prototype(50, TaskType::Development, description);
+    Counter copied;
+    for (int i = 0; i < TASKS; ++i) {
+        manager.assignTask(names[i % EMPLOYEES], prototype);
+    }
+    copied.report("assignTask(const Task&)", TASKS);
+
+    std::vector<std::string> descriptions(TASKS, std::string(DESCRIPTION_LENGTH, 'y'));
+    Counter moved;
+    for (int i = 0; i < TASKS; ++i) {
+        manager.assignTask(names[i % EMPLOYEES], Task(50, TaskType::Testing, std::move(descriptions[i])));
+    }
+    moved.report("assignTask(Task&&)", TASKS);
+
+    Counter bumped;
+    for (int i = 0; i < BUMPS; ++i) {
+        manager.bumpPriorityByType(TaskType::Testing, 1);
+    }
+    bumped.report("bumpPriorityByType", BUMPS);
+
+    NullBuffer null;
+    std::streambuf *original = std::cout.rdbuf(&null);
+    Counter printed;
+    manager.printAllTasks();
+    std::cout.rdbuf(original);
+    printed.report("printAllTasks (per task)", EMPLOYEES + 2 * TASKS);
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Assign/complete churn on SortedList<Task> with the default allocator and the pool.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_allocator.cpp Task.cpp StringPool.cpp \
+ *       PoolAllocator.cpp -o bench_allocator
+ */
+#include <chrono>
+#include <cstdio>
+#include "PoolAllocator.h"
+#include "SortedList.h"
+#include "Task.h"
+
+namespace {
+
+    unsigned int g_seed = 12345;
+
+    Task nextTask(int id) {
+        g_seed = g_seed * 1103515245u + 12345u;
+        Task task((g_seed >> 16) % 101, static_cast<TaskType>((g_seed >> 8) % 10), "Run system tests");
+        task.setId(id);
+        return task;
+    }
+
+    // Keeps a queue of backlog tasks alive and runs cycles of one assign and one complete.
+    template<class List>
+    double churn(int backlog, int cycles, int rounds) {
+        g_seed = 12345;
+        auto start = std::chrono::steady_clock::now();
+        int id = 0;
+        for (int round = 0; round < rounds; ++round) {
+            List list;
+            for (int i = 0; i < backlog; ++i) {
+                list.insert(nextTask(id++));
+            }
+            for (int i = 0; i < cycles; ++i) {
+                list.insert(nextTask(id++));
+                list.remove(list.begin());
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+} // namespace
+
+int main() {
+    const int backlogs[] = {100, 10000, 1000000};
+    const int operations = 2000000;
+
+    std::printf("%10s %10s %16s %16s\n", "backlog", "rounds", "std (cycles/s)", "pool (cycles/s)");
+    for (int backlog : backlogs) {
+        int cycles = backlog * 10 > operations ? operations : backlog * 10;
+        int rounds = operations / cycles;
+        double total = static_cast<double>(rounds) * cycles;
+        double standard = churn<mtm::SortedList<Task>>(backlog, cycles, rounds);
+        double pool = churn<mtm::SortedList<Task, mtm::Greater<Task>, mtm::PoolAllocator<Task>>>(backlog, cycles, rounds);
+        std::printf("%10d %10d %16.0f %16.0f\n", backlog, rounds, total / standard, total / pool);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Assigning 1M tasks to 100 employees one by one with assignTask and in batches of 4096
+ * with assignTasks, then completing all of them with completeTask and with completeTasks,
+ * in sequential and in concurrent mode. An optional argument sets the task count.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -pthread -I. bench/bench_batch.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp StringPool.cpp PoolAllocator.cpp -o bench_batch
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TaskManager.h"
+
+namespace {
+
+    const int EMPLOYEES = 100;
+    const std::size_t BATCH = 4096;
+    const TaskType TYPES[] = {TaskType::Meeting, TaskType::Documentation, TaskType::Development,
+                              TaskType::Testing, TaskType::General};
+
+    template<class Function>
+    double seconds(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    std::vector<std::pair<std::string, Task>> makeTasks(int count) {
+        std::vector<std::pair<std::string, Task>> tasks;
+        tasks.reserve(count);
+        unsigned int seed = 12345;
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            tasks.emplace_back("Employee" + std::to_string((seed >> 8) % EMPLOYEES),
+                               Task(static_cast<int>(seed >> 16) % 101, TYPES[(seed >> 4) % 5], "Review pull request"));
+        }
+        return tasks;
+    }
+
+    void run(const char *mode, bool concurrent, int count) {
+        double single;
+        double singleComplete;
+        {
+            std::vector<std::pair<std::string, Task>> tasks = makeTasks(count);
+            TaskManager manager(false, concurrent);
+            single = seconds([&manager, &tasks]() {
+                for (std::pair<std::string, Task> &entry : tasks) {
+                    manager.assignTask(entry.first, std::move(entry.second));
+                }
+            });
+            singleComplete = seconds([&manager]() {
+                for (int e = 0; e < EMPLOYEES; ++e) {
+                    std::string name = "Employee" + std::to_string(e);
+                    try {
+                        while (true) {
+                            manager.completeTask(name);
+                        }
+                    } catch (const std::runtime_error &) {
+                    }
+                }
+            });
+        }
+        double batched;
+        double batchedComplete;
+        {
+            std::vector<std::pair<std::string, Task>> tasks = makeTasks(count);
+            TaskManager manager(false, concurrent);
+            batched = seconds([&manager, &tasks]() {
+                for (std::size_t first = 0; first < tasks.size(); first += BATCH) {
+                    std::size_t last = std::min(tasks.size(), first + BATCH);
+                    manager.assignTasks(std::vector<std::pair<std::string, Task>>(
+                            std::make_move_iterator(tasks.begin() + first), std::make_move_iterator(tasks.begin() + last)));
+                }
+            });
+            batchedComplete = seconds([&manager, count]() {
+                for (int e = 0; e < EMPLOYEES; ++e) {
+                    manager.completeTasks("Employee" + std::to_string(e), count);
+                }
+            });
+        }
+        std::printf("%-12s %12.3f %12.3f %12.3f %12.3f\n", mode, single, batched, singleComplete, batchedComplete);
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int count = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+    std::printf("%d tasks, %d employees, batches of %zu\n", count, EMPLOYEES, BATCH);
+    std::printf("%-12s %12s %12s %12s %12s\n", "", "assign (s)", "batch (s)", "complete (s)", "batch (s)");
+    run("sequential", false, count);
+    run("concurrent", true, count);
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Cost of the comparison in SortedList: inserting and looking up random elements with
+ * the default operator> ordering and with an inline key, for int, Task and a type keyed
+ * by a string.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_compare.cpp Task.cpp StringPool.cpp -o bench_compare
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SortedList.h"
+#include "Task.h"
+
+namespace {
+
+    const int COUNT = 200000;
+
+    struct Named {
+        std::string m_name;
+        int m_value;
+    };
+
+    // Out of line on purpose, like operator> of Task.
+    __attribute__((noinline)) bool operator>(const Named &lhs, const Named &rhs) {
+        return lhs.m_name > rhs.m_name;
+    }
+
+    struct NameKey {
+        const std::string &operator()(const Named &named) const {
+            return named.m_name;
+        }
+    };
+
+    struct IntKey {
+        constexpr int operator()(int value) const {
+            return value;
+        }
+    };
+
+    unsigned int g_seed = 12345;
+
+    unsigned int nextRandom() {
+        g_seed = g_seed * 1103515245u + 12345u;
+        return g_seed >> 8;
+    }
+
+    std::vector<int> makeInts() {
+        std::vector<int> values;
+        for (int i = 0; i < COUNT; ++i) {
+            values.push_back(static_cast<int>(nextRandom()));
+        }
+        return values;
+    }
+
+    std::vector<Task> makeTasks() {
+        std::vector<Task> values;
+        for (int i = 0; i < COUNT; ++i) {
+            Task task(nextRandom() % 101, static_cast<TaskType>(nextRandom() % 10));
+            task.setId(i);
+            values.push_back(task);
+        }
+        return values;
+    }
+
+    std::vector<Named> makeNamed() {
+        std::vector<Named> values;
+        for (int i = 0; i < COUNT; ++i) {
+            values.push_back(Named{"employee-" + std::to_string(nextRandom() % 100000), i});
+        }
+        return values;
+    }
+
+    // Returns nanoseconds per element for inserting every value one by one and finding each once.
+    template<class List, class T>
+    double insertAndFind(const std::vector<T> &values) {
+        auto start = std::chrono::steady_clock::now();
+        List list;
+        for (const T &value : values) {
+            list.insert(value);
+        }
+        int found = 0;
+        for (const T &value : values) {
+            found += (list.find(value) != list.end()) ? 1 : 0;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (found != COUNT) {
+            std::printf("lookup failed\n");
+        }
+        return elapsed.count() * 1e9 / COUNT;
+    }
+
+} // namespace
+
+int main() {
+    std::vector<int> ints = makeInts();
+    std::vector<Task> tasks = makeTasks();
+    std::vector<Named> named = makeNamed();
+
+    std::printf("%-8s %16s %16s\n", "type", "operator> (ns)", "inline key (ns)");
+    std::printf("%-8s %16.1f %16.1f\n", "int",
+                insertAndFind<mtm::SortedList<int>>(ints),
+                insertAndFind<mtm::SortedList<int, mtm::KeyGreater<IntKey>>>(ints));
+    std::printf("%-8s %16.1f %16.1f\n", "Task",
+                insertAndFind<mtm::SortedList<Task>>(tasks),
+                insertAndFind<mtm::SortedList<Task, mtm::KeyGreater<TaskKey>>>(tasks));
+    std::printf("%-8s %16.1f %16.1f\n", "string",
+                insertAndFind<mtm::SortedList<Named>>(named),
+                insertAndFind<mtm::SortedList<Named, mtm::KeyGreater<NameKey>>>(named));
+    return 0;
+}
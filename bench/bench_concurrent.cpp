@@ -0,0 +1,74 @@
+/*
+ * Throughput of a concurrent TaskManager with 1, 4 and 16 threads, each assigning tasks
+ * to its own employee and completing every second one, plus a mixed run where all the
+ * threads share a few employees. The first row is a TaskManager in sequential mode, so
+ * the cost of the locks shows. An optional argument sets the total operation count.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -pthread -I. bench/bench_concurrent.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp StringPool.cpp PoolAllocator.cpp -o bench_concurrent
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TaskManager.h"
+
+namespace {
+
+    const TaskType TYPES[] = {TaskType::Meeting, TaskType::Documentation, TaskType::Development,
+                              TaskType::Testing, TaskType::General};
+
+    // Runs operations / 2 assignments and about as many completions spread over threads threads
+    double run(TaskManager &manager, int threads, int operations, int employees) {
+        int perThread = operations / (2 * threads);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&manager, t, perThread, employees]() {
+                std::string name = "Employee" + std::to_string(t % employees);
+                unsigned int seed = 12345u + static_cast<unsigned int>(t);
+                for (int i = 0; i < perThread; ++i) {
+                    seed = seed * 1103515245u + 12345u;
+                    manager.assignTask(name, Task(static_cast<int>(seed >> 8) % 101, TYPES[(seed >> 20) % 5],
+                                                  "Review pull request"));
+                    if (i % 2 == 1) {
+                        manager.completeTask(name);
+                        manager.completeTask(name);
+                    }
+                }
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int operations = (argc > 1) ? std::atoi(argv[1]) : 4000000;
+    std::printf("%d operations, %u hardware threads\n", operations, std::thread::hardware_concurrency());
+    std::printf("%-12s %8s %12s %14s\n", "employees", "threads", "time (s)", "Mops/s");
+
+    {
+        TaskManager manager(false, false);
+        double time = run(manager, 1, operations, 1);
+        std::printf("%-12s %8s %12.3f %14.2f\n", "sequential", "1", time, operations / time / 1e6);
+    }
+    const int threads[] = {1, 4, 16};
+    for (int count : threads) {
+        TaskManager manager(false, true);
+        double time = run(manager, count, operations, count);
+        std::printf("%-12s %8d %12.3f %14.2f\n", "one each", count, time, operations / time / 1e6);
+    }
+    for (int count : threads) {
+        TaskManager manager(false, true);
+        double time = run(manager, count, operations, 2);
+        std::printf("%-12s %8d %12.3f %14.2f\n", "two shared", count, time, operations / time / 1e6);
+    }
+    return 0;
+}
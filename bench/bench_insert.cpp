@@ -0,0 +1,97 @@
+/*
+ * Insert throughput of SortedList<Task> against the original linear-scan list.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_insert.cpp Task.cpp StringPool.cpp -o bench_insert
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "SortedList.h"
+#include "Task.h"
+
+namespace {
+
+    // The list as it was before the skip list index: every insert walks from the head.
+    template<class T>
+    class LinearList {
+    public:
+        LinearList() : m_head(nullptr) {}
+
+        ~LinearList() {
+            while (m_head != nullptr) {
+                Node *toDelete = m_head;
+                m_head = m_head->m_next;
+                delete toDelete;
+            }
+        }
+
+        void insert(const T &value) {
+            Node *new_node = new Node{value, nullptr};
+            if (m_head == nullptr || !(m_head->m_data > value)) {
+                new_node->m_next = m_head;
+                m_head = new_node;
+                return;
+            }
+            Node *current = m_head;
+            while (current->m_next != nullptr && (current->m_next->m_data > value)) {
+                current = current->m_next;
+            }
+            new_node->m_next = current->m_next;
+            current->m_next = new_node;
+        }
+
+    private:
+        struct Node {
+            T m_data;
+            Node *m_next;
+        };
+        Node *m_head;
+    };
+
+    std::vector<Task> makeTasks(int count) {
+        std::vector<Task> tasks;
+        tasks.reserve(count);
+        unsigned int seed = 12345;
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            Task task((seed >> 16) % 101, static_cast<TaskType>((seed >> 8) % 10));
+            task.setId(i);
+            tasks.push_back(task);
+        }
+        return tasks;
+    }
+
+    template<class List>
+    double insertAll(const std::vector<Task> &tasks) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            List list;
+            for (const Task &task : tasks) {
+                list.insert(task);
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+} // namespace
+
+int main() {
+    const int sizes[] = {1000, 100000, 10000000};
+    // the quadratic list needs hours for 10M elements, so it stops at 100K
+    const int linearLimit = 100000;
+
+    std::printf("%12s %18s %18s\n", "elements", "linear (ins/s)", "skip list (ins/s)");
+    for (int size : sizes) {
+        std::vector<Task> tasks = makeTasks(size);
+        double skip = insertAll<mtm::SortedList<Task>>(tasks);
+        if (size <= linearLimit) {
+            double linear = insertAll<LinearList<Task>>(tasks);
+            std::printf("%12d %18.0f %18.0f\n", size, size / linear, size / skip);
+        } else {
+            std::printf("%12d %18s %18.0f\n", size, "skipped", size / skip);
+        }
+    }
+    return 0;
+}
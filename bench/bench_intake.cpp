@@ -0,0 +1,105 @@
+/*
+ * Submission latency with 8 producer threads handing tasks to a concurrent TaskManager,
+ * either by calling assignTask directly or through a TaskIntake, while two workers keep
+ * completing tasks. Prints p50/p99/p999 of the time a producer spends per task. An
+ * optional argument sets the number of tasks per producer.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -pthread -I. bench/bench_intake.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp TaskIntake.cpp StringPool.cpp PoolAllocator.cpp -o bench_intake
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TaskIntake.h"
+#include "TaskManager.h"
+
+namespace {
+
+    const int PRODUCERS = 8;
+    const int WORKERS = 2;
+    const int EMPLOYEES = 4;
+
+    // Runs the producers with submit(name, task) and returns every per-task latency in nanoseconds
+    template<class Submit>
+    std::vector<long> measure(TaskManager &manager, int perProducer, Submit submit) {
+        std::atomic<bool> done(false);
+        std::vector<std::thread> workers;
+        for (int w = 0; w < WORKERS; ++w) {
+            workers.emplace_back([&manager, &done, w]() {
+                for (int i = 0; !done.load(std::memory_order_relaxed); ++i) {
+                    try {
+                        manager.completeTask("Employee" + std::to_string((w + i) % EMPLOYEES));
+                    } catch (const std::runtime_error &) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        std::vector<std::vector<long>> latencies(PRODUCERS);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&latencies, &submit, p, perProducer]() {
+                std::string name = "Employee" + std::to_string(p % EMPLOYEES);
+                latencies[p].reserve(perProducer);
+                for (int i = 0; i < perProducer; ++i) {
+                    Task task((p * 31 + i) % 101, TaskType::Development, "Review pull request");
+                    auto start = std::chrono::steady_clock::now();
+                    submit(name, std::move(task));
+                    auto end = std::chrono::steady_clock::now();
+                    latencies[p].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                }
+            });
+        }
+        for (std::thread &producer : producers) {
+            producer.join();
+        }
+        done = true;
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+
+        std::vector<long> all;
+        for (const std::vector<long> &latency : latencies) {
+            all.insert(all.end(), latency.begin(), latency.end());
+        }
+        std::sort(all.begin(), all.end());
+        return all;
+    }
+
+    void report(const char *name, const std::vector<long> &sorted) {
+        auto at = [&sorted](double fraction) {
+            return sorted[static_cast<std::size_t>(fraction * (sorted.size() - 1))];
+        };
+        std::printf("%-10s %12ld %12ld %12ld\n", name, at(0.5), at(0.99), at(0.999));
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int perProducer = (argc > 1) ? std::atoi(argv[1]) : 200000;
+    std::printf("%d producers x %d tasks, %d completing workers, %u hardware threads\n", PRODUCERS, perProducer,
+                WORKERS, std::thread::hardware_concurrency());
+    std::printf("%-10s %12s %12s %12s\n", "", "p50 (ns)", "p99 (ns)", "p999 (ns)");
+    {
+        TaskManager manager(false, true);
+        report("direct", measure(manager, perProducer, [&manager](const std::string &name, Task &&task) {
+            manager.assignTask(name, std::move(task));
+        }));
+    }
+    {
+        TaskManager manager(false, true);
+        TaskIntake intake(manager);
+        report("intake", measure(manager, perProducer, [&intake](const std::string &name, Task &&task) {
+            intake.submit(name, std::move(task));
+        }));
+        intake.flush();
+    }
+    return 0;
+}
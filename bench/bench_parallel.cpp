@@ -0,0 +1,72 @@
+/*
+ * Scaling of the parallel filter and apply of SortedList<int> on a 10M-element list
+ * with pools of 1 to 8 threads; the 1-thread rows are the sequential path. An optional
+ * argument sets the list length.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -pthread -I. bench/bench_parallel.cpp ThreadPool.cpp -o bench_parallel
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "SortedList.h"
+#include "ThreadPool.h"
+
+namespace {
+
+    template<class Function>
+    double seconds(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 10000000;
+    mtm::SortedList<int> list;
+    {
+        std::vector<int> values;
+        values.reserve(size);
+        unsigned int seed = 12345;
+        for (int i = 0; i < size; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            values.push_back(static_cast<int>(seed >> 4));
+        }
+        list.insert(values.begin(), values.end());
+    }
+
+    std::printf("%d elements, %u hardware threads\n", size, std::thread::hardware_concurrency());
+    std::printf("%8s %12s %12s %12s %12s\n", "threads", "filter (s)", "speedup", "apply (s)", "speedup");
+    double filterBase = 0;
+    double applyBase = 0;
+    const unsigned int threads[] = {1, 2, 4, 8};
+    for (unsigned int count : threads) {
+        mtm::ThreadPool pool(count);
+        mtm::ParallelPolicy policy(100000, &pool);
+        int kept = 0;
+        double filter = seconds([&list, &policy, &kept]() {
+            kept = list.filter([](int value) {
+                return value % 3 == 0;
+            }, policy).length();
+        });
+        double apply = seconds([&list, &policy, &kept]() {
+            kept += list.apply([](int value) {
+                return value ^ 0x5555;
+            }, policy).length();
+        });
+        if (count == 1) {
+            filterBase = filter;
+            applyBase = apply;
+        }
+        std::printf("%8u %12.3f %12.2f %12.3f %12.2f\n", count, filter, filterBase / filter, apply,
+                    applyBase / apply);
+        if (kept == 0) {
+            std::printf("empty run\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * printAllTasks on 10 employees x 100K tasks: the streaming k-way merge against the
+ * original 101 priority passes that inserted every match into a fresh list.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_print_all.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp \
+ *       StringPool.cpp PoolAllocator.cpp -o bench_print_all
+ */
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "TaskManager.h"
+
+namespace {
+
+    const int EMPLOYEES = 10;
+    const int TASKS_PER_EMPLOYEE = 100000;
+
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override {
+            return c;
+        }
+
+        std::streamsize xsputn(const char *, std::streamsize count) override {
+            return count;
+        }
+    };
+
+    // The original algorithm, run on a copy of the same data.
+    void printAllTasksByPriorityPasses(const std::vector<Person> &employees) {
+        SortedList<Task> result;
+        for (int priority = 100; priority >= 0; priority--) {
+            for (const Person &employee : employees) {
+                const TaskQueue &current_tasks = employee.getTasks();
+                for (TaskQueue::ConstIterator it = current_tasks.begin(); it != current_tasks.end(); ++it) {
+                    if ((*it).getPriority() == priority) {
+                        result.insert(*it);
+                    }
+                }
+            }
+        }
+        for (SortedList<Task>::ConstIterator it = result.begin(); it != result.end(); ++it) {
+            std::cout << *it << std::endl;
+        }
+    }
+
+    template<class Function>
+    double timed(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+} // namespace
+
+int main() {
+    TaskManager manager;
+    std::vector<Person> employees;
+    for (int i = 0; i < EMPLOYEES; ++i) {
+        employees.emplace_back("Employee" + std::to_string(i));
+    }
+
+    unsigned int seed = 12345;
+    int id = 0;
+    for (int i = 0; i < EMPLOYEES * TASKS_PER_EMPLOYEE; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int employee = i % EMPLOYEES;
+        Task task((seed >> 16) % 101, static_cast<TaskType>((seed >> 8) % 10), "Run system tests");
+        manager.assignTask(employees[employee].getName(), task);
+        task.setId(id++);
+        employees[employee].assignTask(task);
+    }
+
+    NullBuffer null;
+    std::streambuf *original = std::cout.rdbuf(&null);
+    double passes = timed([&employees]() { printAllTasksByPriorityPasses(employees); });
+    double merged = timed([&manager]() { manager.printAllTasks(); });
+    std::cout.rdbuf(original);
+
+    std::printf("%d employees x %d tasks\n", EMPLOYEES, TASKS_PER_EMPLOYEE);
+    std::printf("%-24s %10.3f s\n", "101 priority passes", passes);
+    std::printf("%-24s %10.3f s\n", "k-way merge", merged);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Opening a snapshot of 10M tasks for 1000 employees with SnapshotReader versus loading it
+ * into a TaskManager, and how much of the mapping is resident after reading one employee,
+ * one type and every task. Resident pages are taken from RssFile in /proc/self/status, so
+ * they only count the file mapping. Optional arguments set the task count and the snapshot
+ * path; a count of 0 opens an existing snapshot at the path and leaves it in place.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -pthread -I. bench/bench_snapshot_reader.cpp SnapshotReader.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp StringPool.cpp PoolAllocator.cpp -o bench_snapshot_reader
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "SnapshotReader.h"
+#include "TaskManager.h"
+
+namespace {
+
+    const int EMPLOYEES = 1000;
+    const int DESCRIPTIONS = 500;
+
+    template<class Function>
+    double seconds(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    // File-backed resident memory in KiB, -1 where /proc is not available
+    long residentFileKib() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, 8, "RssFile:") == 0) {
+                return std::atol(line.c_str() + 8);
+            }
+        }
+        return -1;
+    }
+
+    void writeSnapshot(int count, const std::string &path) {
+        std::vector<std::string> names;
+        for (int e = 0; e < EMPLOYEES; ++e) {
+            names.push_back("Employee" + std::to_string(e));
+        }
+        std::vector<std::string> descriptions;
+        for (int d = 0; d < DESCRIPTIONS; ++d) {
+            descriptions.push_back("Review pull request #" + std::to_string(d));
+        }
+        TaskManager manager(true);
+        unsigned int seed = 12345;
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            manager.assignTask(names[(seed >> 8) % EMPLOYEES],
+                               Task(static_cast<int>(seed >> 16) % 101, static_cast<TaskType>((seed >> 4) % 10),
+                                    descriptions[(seed >> 12) % DESCRIPTIONS]));
+        }
+        manager.saveSnapshot(path);
+    }
+
+    // Touches every field so the reads are not optimized away
+    template<class Range>
+    unsigned long scan(const Range &range) {
+        unsigned long sum = 0;
+        for (const SnapshotReader::TaskView &task : range) {
+            sum += static_cast<unsigned long>(task.getId() + task.getPriority()) + task.getDescription().size();
+        }
+        return sum;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int count = (argc > 1) ? std::atoi(argv[1]) : 10000000;
+    std::string path = (argc > 2) ? argv[2] : "bench_snapshot_reader.bin";
+    if (count > 0) {
+        writeSnapshot(count, path);
+    }
+
+    long before = residentFileKib();
+    unsigned long sum = 0;
+    {
+        auto start = std::chrono::steady_clock::now();
+        SnapshotReader reader(path);
+        std::chrono::duration<double> openTime = std::chrono::steady_clock::now() - start;
+        std::printf("%zu tasks, %zu employees\n", reader.getTaskCount(), reader.getPersonCount());
+        std::printf("%-28s %10.6f s %10ld KiB\n", "open reader", openTime.count(), residentFileKib() - before);
+        double personTime = seconds([&reader, &sum]() {
+            sum += scan(reader.getTasks(reader.getPersonCount() / 2));
+        });
+        std::printf("%-28s %10.6f s %10ld KiB\n", "+ one employee", personTime, residentFileKib() - before);
+        double typeTime = seconds([&reader, &sum]() {
+            sum += scan(reader.getTasksByType(TaskType::Testing));
+        });
+        std::printf("%-28s %10.6f s %10ld KiB\n", "+ one type", typeTime, residentFileKib() - before);
+        double allTime = seconds([&reader, &sum]() {
+            for (std::size_t person = 0; person < reader.getPersonCount(); ++person) {
+                sum += scan(reader.getTasks(person));
+            }
+        });
+        std::printf("%-28s %10.6f s %10ld KiB\n", "+ every task", allTime, residentFileKib() - before);
+    }
+    double loadTime;
+    {
+        TaskManager manager(true);
+        loadTime = seconds([&manager, &path]() {
+            manager.loadSnapshot(path);
+        });
+    }
+    std::printf("%-28s %10.6f s\n", "TaskManager::loadSnapshot", loadTime);
+    if (count > 0) {
+        std::remove(path.c_str());
+    }
+    std::printf("checksum %lu\n", sum);
+    return 0;
+}
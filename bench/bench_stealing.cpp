@@ -0,0 +1,112 @@
+/*
+ * Simulation of 16 employees who each complete one task per tick while 12 new tasks a
+ * tick arrive for them with a skewed (1/rank) distribution. Compares strict assignment
+ * with work stealing: ticks until every task is done (makespan), the variance of the
+ * queue depths averaged over the ticks, the deepest queue seen, and the wall time.
+ * Optional arguments set the number of ticks with arrivals and the arrivals per tick.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -pthread -I. bench/bench_stealing.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp StringPool.cpp PoolAllocator.cpp -o bench_stealing
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TaskManager.h"
+
+namespace {
+
+    const int EMPLOYEES = 16;
+
+    struct Result {
+        int m_makespan;
+        double m_variance;
+        int m_maxDepth;
+        double m_seconds;
+    };
+
+    Result simulate(bool stealing, int arrivalTicks, int arrivalsPerTick) {
+        std::vector<std::string> names;
+        std::vector<double> cumulative;
+        double total = 0;
+        for (int e = 0; e < EMPLOYEES; ++e) {
+            names.push_back("Employee" + std::to_string(e));
+            total += 1.0 / (e + 1);
+            cumulative.push_back(total);
+        }
+
+        TaskManager manager;
+        manager.setWorkStealing(stealing);
+        for (const std::string &name : names) {
+            manager.assignTask(name, Task(0, "Onboarding"));
+        }
+        std::vector<int> depths(EMPLOYEES);
+        unsigned int seed = 12345;
+        Result result{0, 0, 0, 0};
+        double varianceSum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 0;; ++tick) {
+            for (int a = 0; tick < arrivalTicks && a < arrivalsPerTick; ++a) {
+                seed = seed * 1103515245u + 12345u;
+                double pick = (seed >> 8) / 16777216.0 * total;
+                int e = 0;
+                while (cumulative[e] < pick) {
+                    e++;
+                }
+                manager.assignTask(names[e], Task(static_cast<int>(seed >> 4) % 101, "Review pull request"));
+            }
+
+            double sum = 0;
+            double squares = 0;
+            int queued = 0;
+            for (int e = 0; e < EMPLOYEES; ++e) {
+                int depth = manager.getTaskCount(names[e]);
+                depths[e] = depth;
+                sum += depth;
+                squares += static_cast<double>(depth) * depth;
+                queued += depth;
+                result.m_maxDepth = std::max(result.m_maxDepth, depth);
+            }
+            varianceSum += squares / EMPLOYEES - (sum / EMPLOYEES) * (sum / EMPLOYEES);
+            if (queued == 0 && tick >= arrivalTicks) {
+                result.m_makespan = tick;
+                result.m_variance = varianceSum / (tick + 1);
+                break;
+            }
+
+            // with strict assignment an idle employee just waits
+            for (int e = 0; e < EMPLOYEES; ++e) {
+                if (depths[e] == 0 && !stealing) {
+                    continue;
+                }
+                try {
+                    manager.completeTask(names[e]);
+                } catch (const std::runtime_error &) {
+                    // nothing to steal this tick
+                }
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.m_seconds = elapsed.count();
+        return result;
+    }
+
+    void report(const char *mode, const Result &result) {
+        std::printf("%-10s %12d %16.1f %12d %12.3f\n", mode, result.m_makespan, result.m_variance, result.m_maxDepth,
+                    result.m_seconds);
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int arrivalTicks = (argc > 1) ? std::atoi(argv[1]) : 20000;
+    int arrivalsPerTick = (argc > 2) ? std::atoi(argv[2]) : 12;
+    std::printf("%d employees, %d ticks x %d arrivals\n", EMPLOYEES, arrivalTicks, arrivalsPerTick);
+    std::printf("%-10s %12s %16s %12s %12s\n", "", "makespan", "depth variance", "max depth", "time (s)");
+    report("strict", simulate(false, arrivalTicks, arrivalsPerTick));
+    report("stealing", simulate(true, arrivalTicks, arrivalsPerTick));
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * Live heap bytes per task for 1M tasks in a SortedList<Task> whose descriptions come
+ * from a small set of common texts, with a private copy per task and interned in a
+ * StringPool, plus the bytes added by copying the whole list.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_task_layout.cpp Task.cpp StringPool.cpp \
+ *       PoolAllocator.cpp -o bench_task_layout
+ */
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "SortedList.h"
+#include "StringPool.h"
+#include "Task.h"
+
+namespace {
+
+    const int TASKS = 1000000;
+    const char *const DESCRIPTIONS[] = {
+        "Write unit tests for the scheduling module",
+        "Fix bug in UI when resizing the main window",
+        "Weekly team meeting with the product owners",
+        "Prepare the quarterly presentation for management",
+        "Update the developer documentation for the API",
+        "Run system tests on the nightly build",
+        "Research alternatives for the storage backend",
+        "Onboarding training for the new team members",
+    };
+    const int DESCRIPTION_COUNT = sizeof(DESCRIPTIONS) / sizeof(DESCRIPTIONS[0]);
+
+    // every block carries its size in front so that live bytes can be tracked on free
+    const std::size_t HEADER = alignof(std::max_align_t);
+    std::size_t g_liveBytes = 0;
+
+    template<class MakeTask>
+    void measure(const char *name, MakeTask makeTask) {
+        std::size_t before = g_liveBytes;
+        mtm::SortedList<Task> tasks;
+        unsigned int seed = 12345;
+        for (int i = 0; i < TASKS; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            Task task = makeTask((seed >> 16) % 101, static_cast<TaskType>((seed >> 8) % 10),
+                                 DESCRIPTIONS[(seed >> 4) % DESCRIPTION_COUNT]);
+            task.setId(i);
+            tasks.insert(task);
+        }
+        std::size_t filled = g_liveBytes;
+        mtm::SortedList<Task> copy(tasks);
+        std::printf("%-10s %14.1f %14.1f\n", name, static_cast<double>(filled - before) / TASKS,
+                    static_cast<double>(g_liveBytes - filled) / TASKS);
+    }
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    auto *block = static_cast<unsigned char *>(std::malloc(size + HEADER));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+    g_liveBytes += size;
+    return block + HEADER;
+}
+
+/*
+ * Every pointer operator delete receives came from the replaced operator new above, which
+ * offsets a malloc'd block by HEADER, so stepping back and calling std::free is right.
+ * Once the calls are inlined GCC sees only the object that was handed out, and flags the
+ * step back with -Warray-bounds and the release with -Wmismatched-new-delete; neither
+ * warning applies here.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#if __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+#endif
+
+void operator delete(void *memory) noexcept {
+    if (memory == nullptr) {
+        return;
+    }
+    auto *block = static_cast<unsigned char *>(memory) - HEADER;
+    g_liveBytes -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int main() {
+    std::printf("sizeof(Task) = %zu\n", sizeof(Task));
+    std::printf("%-10s %14s %14s\n", "mode", "bytes/task", "copy bytes/task");
+    measure("private", [](int priority, TaskType type, const char *description) {
+        return Task(priority, type, description);
+    });
+    StringPool pool;
+    measure("interned", [&pool](int priority, TaskType type, const char *description) {
+        return Task(priority, type, pool, description);
+    });
+    return 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Per-person task storage: the skip list SortedList<Task> against the priority-bucket
+ * TaskQueue, for assigning tasks with increasing IDs, completing the highest priority
+ * task and bumping every task of one type.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_task_queue.cpp Task.cpp StringPool.cpp TaskQueue.cpp \
+ *       -o bench_task_queue
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "SortedList.h"
+#include "Task.h"
+#include "TaskQueue.h"
+
+namespace {
+
+    const int BUMPS = 100;
+
+    std::vector<Task> makeTasks(int count) {
+        std::vector<Task> tasks;
+        tasks.reserve(count);
+        unsigned int seed = 12345;
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            Task task((seed >> 16) % 101, static_cast<TaskType>((seed >> 8) % 10));
+            task.setId(i);
+            tasks.push_back(task);
+        }
+        return tasks;
+    }
+
+    template<class Function>
+    double timed(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    // Returns the seconds spent assigning every task, bumping one type and completing every task.
+    template<class List>
+    void run(const std::vector<Task> &tasks, double seconds[3]) {
+        List list;
+        seconds[0] = timed([&list, &tasks]() {
+            for (const Task &task : tasks) {
+                list.insert(task);
+            }
+        });
+        seconds[1] = timed([&list]() {
+            for (int i = 0; i < BUMPS; ++i) {
+                list.update_if([](const Task &task) {
+                    return task.getType() == TaskType::Testing;
+                }, [](Task &task) {
+                    task.setPriority(task.getPriority() + (task.getPriority() < 100 ? 1 : -100));
+                });
+            }
+        });
+        seconds[2] = timed([&list]() {
+            while (list.length() > 0) {
+                list.remove(list.begin());
+            }
+        });
+    }
+
+} // namespace
+
+int main() {
+    const int sizes[] = {1000, 100000, 1000000};
+
+    std::printf("%10s %10s %14s %14s %14s\n", "tasks", "list", "assign (ns)", "bump (ns)", "complete (ns)");
+    for (int size : sizes) {
+        std::vector<Task> tasks = makeTasks(size);
+        double skip[3];
+        double buckets[3];
+        run<mtm::SortedList<Task>>(tasks, skip);
+        run<TaskQueue>(tasks, buckets);
+        std::printf("%10d %10s %14.1f %14.1f %14.1f\n", size, "skip list", skip[0] * 1e9 / size,
+                    skip[1] * 1e9 / (static_cast<double>(BUMPS) * size), skip[2] * 1e9 / size);
+        std::printf("%10d %10s %14.1f %14.1f %14.1f\n", size, "buckets", buckets[0] * 1e9 / size,
+                    buckets[1] * 1e9 / (static_cast<double>(BUMPS) * size), buckets[2] * 1e9 / size);
+    }
+    return 0;
+}
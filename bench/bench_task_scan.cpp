@@ -0,0 +1,132 @@
+/*
+ * Scanning a 10K-task list: finding where a new task goes and collecting the tasks of
+ * one type, by walking a SortedList<Task> with one operator> call per node and with
+ * the TaskScan kernels over packed keys and types at every supported level.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_task_scan.cpp Task.cpp StringPool.cpp TaskScan.cpp \
+ *       -o bench_task_scan
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "SortedList.h"
+#include "Task.h"
+#include "TaskScan.h"
+
+namespace {
+
+    const int TASKS = 10000;
+    const int LOOKUPS = 100000;
+    const int FILTERS = 2000;
+
+    unsigned int g_seed = 12345;
+
+    unsigned int nextRandom() {
+        g_seed = g_seed * 1103515245u + 12345u;
+        return g_seed >> 8;
+    }
+
+    Task makeTask(int id) {
+        Task task(nextRandom() % 101, static_cast<TaskType>(nextRandom() % 10));
+        task.setId(id);
+        return task;
+    }
+
+    template<class Function>
+    double nanosecondsPer(int repeats, Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() * 1e9 / repeats;
+    }
+
+    const char *levelName(ScanLevel level) {
+        switch (level) {
+            case ScanLevel::Avx2:
+                return "avx2";
+            case ScanLevel::Sse42:
+                return "sse4.2";
+            default:
+                return "scalar";
+        }
+    }
+
+} // namespace
+
+int main() {
+    mtm::SortedList<Task> list;
+    for (int i = 0; i < TASKS; ++i) {
+        list.insert(makeTask(i));
+    }
+    std::vector<std::uint64_t> keys;
+    std::vector<TaskType> types;
+    for (const Task &task : list) {
+        keys.push_back(TaskKey()(task));
+        types.push_back(task.getType());
+    }
+    std::vector<Task> probes;
+    for (int i = 0; i < LOOKUPS; ++i) {
+        probes.push_back(makeTask(TASKS + static_cast<int>(nextRandom() % TASKS)));
+    }
+    std::vector<std::uint64_t> probeKeys;
+    for (const Task &probe : probes) {
+        probeKeys.push_back(TaskKey()(probe));
+    }
+    std::vector<std::uint32_t> positions(types.size());
+    std::size_t checksum = 0;
+
+    std::printf("%d tasks, ns per call\n", TASKS);
+    std::printf("%-22s %16s %16s\n", "path", "insertion point", "tasks of type");
+
+    double walkInsert = nanosecondsPer(LOOKUPS / 100, [&list, &probes, &checksum]() {
+        for (int i = 0; i < LOOKUPS / 100; ++i) {
+            std::size_t position = 0;
+            for (auto it = list.begin(); it != list.end() && *it > probes[i]; ++it) {
+                ++position;
+            }
+            checksum += position;
+        }
+    });
+    double walkType = nanosecondsPer(FILTERS, [&list, &positions, &checksum]() {
+        for (int i = 0; i < FILTERS; ++i) {
+            auto type = static_cast<TaskType>(i % 10);
+            std::size_t found = 0;
+            std::uint32_t index = 0;
+            for (const Task &task : list) {
+                if (task.getType() == type) {
+                    positions[found++] = index;
+                }
+                ++index;
+            }
+            checksum += found;
+        }
+    });
+    std::printf("%-22s %16.1f %16.1f\n", "operator> per node", walkInsert, walkType);
+
+    const ScanLevel levels[] = {ScanLevel::Scalar, ScanLevel::Sse42, ScanLevel::Avx2};
+    for (ScanLevel level : levels) {
+        if (setScanLevel(level) != level) {
+            continue;
+        }
+        double insert = nanosecondsPer(LOOKUPS, [&keys, &probeKeys, &checksum]() {
+            for (std::uint64_t key : probeKeys) {
+                checksum += scanInsertionPoint(keys.data(), keys.size(), key);
+            }
+        });
+        double type = nanosecondsPer(FILTERS, [&types, &positions, &checksum]() {
+            for (int i = 0; i < FILTERS; ++i) {
+                checksum += scanTasksOfType(types.data(), types.size(), static_cast<TaskType>(i % 10),
+                                            positions.data());
+            }
+        });
+        std::printf("packed keys, %-10s %16.1f %16.1f\n", levelName(level), insert, type);
+    }
+    setScanLevel(getSupportedScanLevel());
+
+    if (checksum == 0) {
+        std::printf("empty run\n");
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Type queries when 1% of the tasks are TaskType::Research: the per-type index in
+ * TaskManager against scanning every employee's list.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_type_index.cpp Task.cpp Person.cpp TaskQueue.cpp TaskManager.cpp TaskSnapshot.cpp \
+ *       StringPool.cpp PoolAllocator.cpp -o bench_type_index
+ */
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "TaskManager.h"
+
+namespace {
+
+    const int EMPLOYEES = 10;
+    const int TASKS_PER_EMPLOYEE = 100000;
+    const int QUERIES = 20;
+
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override {
+            return c;
+        }
+
+        std::streamsize xsputn(const char *, std::streamsize count) override {
+            return count;
+        }
+    };
+
+    void printTasksByScanning(const std::vector<Person> &employees, TaskType type) {
+        std::vector<SortedList<Task>> matches;
+        for (const Person &employee : employees) {
+            matches.emplace_back();
+            for (const Task &task : employee.getTasks()) {
+                if (task.getType() == type) {
+                    matches.back().insert(task);
+                }
+            }
+        }
+        SortedList<Task> result;
+        result.merge(matches.begin(), matches.end());
+        for (const Task &task : result) {
+            std::cout << task << std::endl;
+        }
+    }
+
+    template<class Function>
+    double timed(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < QUERIES; ++i) {
+            function();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / QUERIES;
+    }
+
+} // namespace
+
+int main() {
+    TaskManager manager;
+    std::vector<Person> employees;
+    for (int i = 0; i < EMPLOYEES; ++i) {
+        employees.emplace_back("Employee" + std::to_string(i));
+    }
+
+    unsigned int seed = 12345;
+    for (int i = 0; i < EMPLOYEES * TASKS_PER_EMPLOYEE; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int employee = i % EMPLOYEES;
+        TaskType type = (seed >> 8) % 100 == 0 ? TaskType::Research : TaskType::Development;
+        Task task((seed >> 16) % 101, type, "Explore new tech");
+        manager.assignTask(employees[employee].getName(), task);
+        task.setId(i);
+        employees[employee].assignTask(task);
+    }
+
+    NullBuffer null;
+    std::streambuf *original = std::cout.rdbuf(&null);
+    double scanPrint = timed([&employees]() { printTasksByScanning(employees, TaskType::Research); });
+    double indexPrint = timed([&manager]() { manager.printTasksByType(TaskType::Research); });
+    double scanBump = timed([&employees]() {
+        for (Person &employee : employees) {
+            employee.bumpTaskPriorities(TaskType::Research, 1);
+        }
+    });
+    double indexBump = timed([&manager]() { manager.bumpPriorityByType(TaskType::Research, 1); });
+    std::cout.rdbuf(original);
+
+    std::printf("%d employees x %d tasks, 1%% Research, mean of %d calls\n", EMPLOYEES, TASKS_PER_EMPLOYEE, QUERIES);
+    std::printf("%-22s %12s %12s\n", "", "scan (ms)", "index (ms)");
+    std::printf("%-22s %12.3f %12.3f\n", "printTasksByType", scanPrint * 1000, indexPrint * 1000);
+    std::printf("%-22s %12.3f %12.3f\n", "bumpPriorityByType", scanBump * 1000, indexBump * 1000);
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Node-per-element SortedList against the block-based UnrolledSortedList: inserting
+ * random elements one by one and in bulk, and traversing the list through iteration,
+ * filter, apply and operator==, for int and Task.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_unrolled.cpp Task.cpp StringPool.cpp -o bench_unrolled
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "SortedList.h"
+#include "Task.h"
+#include "UnrolledSortedList.h"
+
+namespace {
+
+    const int PASSES = 10;
+
+    unsigned int g_seed = 12345;
+
+    unsigned int nextRandom() {
+        g_seed = g_seed * 1103515245u + 12345u;
+        return g_seed >> 8;
+    }
+
+    std::vector<int> makeInts(int count) {
+        std::vector<int> values;
+        for (int i = 0; i < count; ++i) {
+            values.push_back(static_cast<int>(nextRandom()));
+        }
+        return values;
+    }
+
+    std::vector<Task> makeTasks(int count) {
+        std::vector<Task> values;
+        for (int i = 0; i < count; ++i) {
+            Task task(nextRandom() % 101, static_cast<TaskType>(nextRandom() % 10));
+            task.setId(i);
+            values.push_back(task);
+        }
+        return values;
+    }
+
+    int keyOf(int value) {
+        return value;
+    }
+
+    int keyOf(const Task &task) {
+        return task.getId();
+    }
+
+    template<class Function>
+    double timed(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    /*
+     * Fills seconds with the time to insert the values one by one, to insert them in
+     * bulk, and for PASSES traversals by iteration, filter, apply and operator==.
+     */
+    template<class List, class T>
+    void run(const std::vector<T> &values, double seconds[6]) {
+        long long checksum = 0;
+        List list;
+        seconds[0] = timed([&list, &values]() {
+            for (const T &value : values) {
+                list.insert(value);
+            }
+        });
+        seconds[1] = timed([&values]() {
+            List bulk;
+            bulk.insert(values.begin(), values.end());
+        });
+        seconds[2] = timed([&list, &checksum]() {
+            for (int pass = 0; pass < PASSES; ++pass) {
+                for (const T &value : list) {
+                    checksum += keyOf(value);
+                }
+            }
+        });
+        seconds[3] = timed([&list, &checksum]() {
+            for (int pass = 0; pass < PASSES; ++pass) {
+                checksum += list.filter([](const T &value) {
+                    return keyOf(value) % 2 == 0;
+                }).length();
+            }
+        });
+        seconds[4] = timed([&list, &checksum]() {
+            for (int pass = 0; pass < PASSES; ++pass) {
+                checksum += list.apply([](const T &value) {
+                    return value;
+                }).length();
+            }
+        });
+        List copy(list);
+        seconds[5] = timed([&list, &copy, &checksum]() {
+            for (int pass = 0; pass < PASSES; ++pass) {
+                checksum += (list == copy) ? 1 : 0;
+            }
+        });
+        if (checksum == 0) {
+            std::printf("empty run\n");
+        }
+    }
+
+    template<class T>
+    void report(const char *type, const std::vector<T> &values) {
+        double nodes[6];
+        double blocks[6];
+        run<mtm::SortedList<T>>(values, nodes);
+        run<mtm::UnrolledSortedList<T>>(values, blocks);
+        double size = static_cast<double>(values.size());
+        const char *names[] = {"nodes", "blocks"};
+        double *results[] = {nodes, blocks};
+        for (int i = 0; i < 2; ++i) {
+            double *seconds = results[i];
+            std::printf("%-6s %8zu %7s %9.1f %9.1f %9.2f %9.2f %9.2f %9.2f\n", type, values.size(), names[i],
+                        seconds[0] * 1e9 / size, seconds[1] * 1e9 / size, seconds[2] * 1e9 / (PASSES * size),
+                        seconds[3] * 1e9 / (PASSES * size), seconds[4] * 1e9 / (PASSES * size),
+                        seconds[5] * 1e9 / (PASSES * size));
+        }
+    }
+
+} // namespace
+
+// Task has no equality of its own; operator== of the lists needs one.
+bool operator!=(const Task &lhs, const Task &rhs) {
+    return lhs.getId() != rhs.getId() || lhs.getPriority() != rhs.getPriority();
+}
+
+int main() {
+    const int sizes[] = {1000, 100000, 1000000};
+
+    std::printf("all times in ns per element\n");
+    std::printf("%-6s %8s %7s %9s %9s %9s %9s %9s %9s\n", "type", "size", "layout", "insert", "bulk", "iterate",
+                "filter", "apply", "equal");
+    for (int size : sizes) {
+        report("int", makeInts(size));
+        report("Task", makeTasks(size));
+    }
+    return 0;
+}
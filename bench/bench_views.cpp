@@ -0,0 +1,109 @@
+/*
+ * Eager filter/apply against the lazy filtered/transformed views on a SortedList<Task>
+ * of 1M tasks: time and heap allocations for summing the selected priorities, for a
+ * filter then apply chain, and for turning the chain into a list.
+ *
+ * Build from the repository root:
+ *   g++ -std=c++17 -O2 -DNDEBUG -I. bench/bench_views.cpp Task.cpp StringPool.cpp -o bench_views
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "SortedList.h"
+#include "Task.h"
+
+namespace {
+
+    const int TASKS = 1000000;
+
+    std::size_t g_allocations = 0;
+
+    bool isTesting(const Task &task) {
+        return task.getType() == TaskType::Testing;
+    }
+
+    Task bumped(const Task &task) {
+        Task result = task;
+        result.setPriority(task.getPriority() + 1);
+        return result;
+    }
+
+    // Times function and prints the nanoseconds per task and the allocations it made.
+    template<class Function>
+    void measure(const char *name, Function function) {
+        std::size_t allocations = g_allocations;
+        auto start = std::chrono::steady_clock::now();
+        long long sum = function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-30s %10.2f %12zu %14lld\n", name, elapsed.count() * 1e9 / TASKS,
+                    g_allocations - allocations, sum);
+    }
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    g_allocations++;
+    void *memory = std::malloc(size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+int main() {
+    mtm::SortedList<Task> tasks;
+    unsigned int seed = 12345;
+    for (int i = 0; i < TASKS; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        Task task((seed >> 16) % 100, static_cast<TaskType>((seed >> 8) % 10));
+        task.setId(i);
+        tasks.insert(task);
+    }
+
+    std::printf("%-30s %10s %12s %14s\n", "operation", "ns/task", "allocations", "checksum");
+    measure("filter, sum", [&tasks]() {
+        long long sum = 0;
+        for (const Task &task : tasks.filter(isTesting)) {
+            sum += task.getPriority();
+        }
+        return sum;
+    });
+    measure("filtered, sum", [&tasks]() {
+        long long sum = 0;
+        for (const Task &task : tasks.filtered(isTesting)) {
+            sum += task.getPriority();
+        }
+        return sum;
+    });
+    measure("filter + apply, sum", [&tasks]() {
+        long long sum = 0;
+        for (const Task &task : tasks.filter(isTesting).apply(bumped)) {
+            sum += task.getPriority();
+        }
+        return sum;
+    });
+    measure("filtered + transformed, sum", [&tasks]() {
+        long long sum = 0;
+        for (const Task &task : tasks.filtered(isTesting).transformed(bumped)) {
+            sum += task.getPriority();
+        }
+        return sum;
+    });
+    measure("filter + apply, list", [&tasks]() {
+        return static_cast<long long>(tasks.filter(isTesting).apply(bumped).length());
+    });
+    measure("filtered + transformed, list", [&tasks]() {
+        return static_cast<long long>(tasks.filtered(isTesting).transformed(bumped).toList().length());
+    });
+    return 0;
+}
@@ -1,7 +1,22 @@
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PoolAllocator.h"
+#include "SnapshotReader.h"
+#include "TaskIntake.h"
 #include "TaskManager.h"
 #include "Task.h"
+#include "TaskScan.h"
+#include "ThreadPool.h"
+#include "UnrolledSortedList.h"
 
 using std::cout;
 using std::endl;
@@ -211,6 +226,773 @@ bool testListBasic()
 
 
 
+bool testListMove()
+{
+    SortedList<int> list;
+    list.insert(5);
+    list.insert(3);
+    list.insert(8);
+    const int *first = &(*list.begin());
+
+    // Move constructor takes over the nodes
+    SortedList<int> moved(std::move(list));
+    ASSERT_TEST(moved.length() == 3);
+    ASSERT_TEST(list.length() == 0);
+    ASSERT_TEST(&(*moved.begin()) == first);
+
+    // Move assignment releases the old nodes and takes over the new ones
+    SortedList<int> target;
+    target.insert(1);
+    target = std::move(moved);
+    ASSERT_TEST(target.length() == 3);
+    ASSERT_TEST(&(*target.begin()) == first);
+
+    // Copies keep the source order and stay usable
+    SortedList<int> copy(target);
+    copy.insert(4);
+    int expected[] = {8, 5, 4, 3};
+    int i = 0;
+    for (int value : copy)
+    {
+        ASSERT_TEST(value == expected[i++]);
+    }
+    ASSERT_TEST(target.length() == 3);
+
+    return true;
+}
+
+bool testListMerge()
+{
+    SortedList<int> first;
+    first.insert(9);
+    first.insert(4);
+    first.insert(1);
+    SortedList<int> second;
+    second.insert(7);
+    second.insert(4);
+    const int *seven = &(*second.begin());
+
+    // Two-way merge moves the nodes and empties the source
+    first.merge(second);
+    ASSERT_TEST(first.length() == 5);
+    ASSERT_TEST(second.length() == 0);
+    ASSERT_TEST(&(*(++first.begin())) == seven);
+
+    // k-way merge over several lists
+    SortedList<int> lists[3];
+    lists[0].insert(10);
+    lists[1].insert(0);
+    lists[1].insert(5);
+    lists[2].insert(3);
+    first.merge(lists, lists + 3);
+    int expected[] = {10, 9, 7, 5, 4, 4, 3, 1, 0};
+    int i = 0;
+    for (int value : first)
+    {
+        ASSERT_TEST(value == expected[i++]);
+    }
+    ASSERT_TEST(i == 9);
+    for (const SortedList<int> &list : lists)
+    {
+        ASSERT_TEST(list.length() == 0);
+    }
+
+    return true;
+}
+
+bool testListPoolAllocator()
+{
+    typedef mtm::PoolAllocator<int> Pool;
+    typedef SortedList<int, mtm::Greater<int>, Pool> PoolList;
+    Pool pool;
+    PoolList list(pool);
+    for (int i = 0; i < 20; ++i)
+    {
+        list.insert(i % 7);
+    }
+    ASSERT_TEST(list.get_allocator() == pool);
+
+    // A copy gets a fresh pool and keeps its nodes after the original is gone
+    PoolList *original = new PoolList(list);
+    PoolList copy(*original);
+    ASSERT_TEST(copy.get_allocator() != original->get_allocator());
+    delete original;
+    ASSERT_TEST(copy == list);
+
+    // Moving steals the pool together with the nodes
+    const int *first = &(*copy.begin());
+    Pool copyPool = copy.get_allocator();
+    PoolList moved(std::move(copy));
+    ASSERT_TEST(moved.get_allocator() == copyPool && &(*moved.begin()) == first);
+    PoolList assigned;
+    assigned.insert(100);
+    assigned = std::move(moved);
+    ASSERT_TEST(assigned.get_allocator() == copyPool && &(*assigned.begin()) == first);
+
+    // Copy assignment keeps the target's pool
+    Pool otherPool;
+    PoolList target(otherPool);
+    target = assigned;
+    ASSERT_TEST(target.get_allocator() == otherPool && target == assigned);
+
+    // Merging across unequal pools copies the values into the target's pool and empties the source
+    PoolList *source = new PoolList;
+    source->insert(3);
+    source->insert(50);
+    list.merge(*source);
+    ASSERT_TEST(source->length() == 0 && list.get_allocator() == pool);
+    delete source;
+    ASSERT_TEST(list.length() == 22 && *list.begin() == 50);
+    int previous = *list.begin();
+    for (int value : list)
+    {
+        ASSERT_TEST(value <= previous);
+        previous = value;
+    }
+
+    // Merging within one pool moves the nodes themselves
+    PoolList sibling(pool);
+    sibling.insert(7);
+    const int *seven = &(*sibling.begin());
+    list.merge(sibling);
+    ASSERT_TEST(sibling.length() == 0 && &(*(++list.begin())) == seven);
+
+    return true;
+}
+
+// Orders pairs by their first member only, so the second one tells equal elements apart
+struct GreaterFirst
+{
+    bool operator()(const std::pair<int, int> &a, const std::pair<int, int> &b) const
+    {
+        return a.first > b.first;
+    }
+};
+
+bool sameOrder(const SortedList<std::pair<int, int>, GreaterFirst> &bulk,
+               const SortedList<std::pair<int, int>, GreaterFirst> &single)
+{
+    if (bulk.length() != single.length())
+    {
+        return false;
+    }
+    auto other = single.begin();
+    for (const std::pair<int, int> &value : bulk)
+    {
+        if (value != *other)
+        {
+            return false;
+        }
+        ++other;
+    }
+    return true;
+}
+
+bool testListBulkInsert()
+{
+    typedef SortedList<std::pair<int, int>, GreaterFirst> PairList;
+    const int count = 300;
+    std::vector<std::pair<int, int>> ascending;
+    std::vector<std::pair<int, int>> descending;
+    std::vector<std::pair<int, int>> shuffled;
+    unsigned int seed = 2024;
+    for (int i = 0; i < count; ++i)
+    {
+        ascending.emplace_back(i / 4, i);
+        descending.emplace_back((count - i) / 4, i);
+        seed = seed * 1103515245u + 12345u;
+        shuffled.emplace_back(static_cast<int>((seed >> 16) % 20), i);
+    }
+
+    // Bulk insertion keeps equal elements in the order repeated insert() gives them,
+    // for input already in list order, in reverse order and in no order
+    for (const std::vector<std::pair<int, int>> *input : {&ascending, &descending, &shuffled})
+    {
+        PairList single;
+        for (const std::pair<int, int> &value : *input)
+        {
+            single.insert(value);
+        }
+        PairList constructed(input->begin(), input->end());
+        ASSERT_TEST(sameOrder(constructed, single));
+
+        // Into a list that already holds equal elements, in two batches
+        PairList bulk;
+        PairList oneByOne;
+        for (int key = 0; key < 20; key += 3)
+        {
+            bulk.insert(std::make_pair(key, -1 - key));
+            oneByOne.insert(std::make_pair(key, -1 - key));
+        }
+        auto middle = input->begin() + count / 2;
+        bulk.insert(input->begin(), middle);
+        bulk.insert(middle, input->end());
+        for (const std::pair<int, int> &value : *input)
+        {
+            oneByOne.insert(value);
+        }
+        ASSERT_TEST(sameOrder(bulk, oneByOne));
+    }
+
+    // An empty range changes nothing
+    PairList list;
+    list.insert(ascending.begin(), ascending.begin());
+    ASSERT_TEST(list.length() == 0);
+
+    return true;
+}
+
+bool testListUpdate()
+{
+    typedef SortedList<std::pair<int, int>, GreaterFirst> PairList;
+    PairList list;
+    const int keys[] = {10, 10, 20, 20, 30, 5};
+    for (int tag = 0; tag < 6; ++tag)
+    {
+        list.insert(std::make_pair(keys[tag], tag));
+    }
+    auto inOrder = [&list](const std::vector<std::pair<int, int>> &expected) {
+        return list.length() == static_cast<int>(expected.size()) &&
+               std::equal(expected.begin(), expected.end(), list.begin());
+    };
+    // Every element is still there exactly once, in order of the keys
+    auto intact = [&list]() {
+        int tags = 0;
+        int previous = std::numeric_limits<int>::max();
+        for (const std::pair<int, int> &value : list)
+        {
+            if (value.first > previous)
+            {
+                return false;
+            }
+            previous = value.first;
+            tags |= 1 << value.second;
+        }
+        return list.length() == 6 && tags == 0x3f;
+    };
+    ASSERT_TEST(inOrder({{30, 4}, {20, 3}, {20, 2}, {10, 1}, {10, 0}, {5, 5}}));
+
+    // Updated elements keep their order and go in front of the equal ones already there
+    int updated = list.update_if([](const std::pair<int, int> &value) { return value.second >= 4; },
+                                 [](std::pair<int, int> &value) { value.first = 20; });
+    ASSERT_TEST(updated == 2);
+    ASSERT_TEST(inOrder({{20, 4}, {20, 5}, {20, 3}, {20, 2}, {10, 1}, {10, 0}}));
+    auto it = list.find(std::make_pair(10, -1));
+    ASSERT_TEST(*it == std::make_pair(10, 1));
+    list.update(it, [](std::pair<int, int> &value) { value.first = 20; });
+    ASSERT_TEST(*it == std::make_pair(20, 1) && it == list.begin());
+    ASSERT_TEST(inOrder({{20, 1}, {20, 4}, {20, 5}, {20, 3}, {20, 2}, {10, 0}}));
+
+    // find only returns equivalent elements
+    ASSERT_TEST(list.find(std::make_pair(15, 0)) == list.end());
+    ASSERT_TEST(list.find(std::make_pair(40, 0)) == list.end());
+    ASSERT_TEST(list.find(std::make_pair(0, 0)) == list.end());
+    PairList empty;
+    ASSERT_TEST(empty.find(std::make_pair(20, 0)) == empty.end());
+
+    // When condition or operation throws, every element is put back in the list
+    int calls = 0;
+    try
+    {
+        list.update_if([&calls](const std::pair<int, int> &value) {
+            if (++calls == 4)
+            {
+                throw std::runtime_error("condition failed");
+            }
+            return value.second == 5;
+        }, [](std::pair<int, int> &value) { value.first = 0; });
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    ASSERT_TEST(intact() && (*list.find(std::make_pair(20, 0))).first == 20);
+    calls = 0;
+    try
+    {
+        list.update_if([](const std::pair<int, int> &value) { return value.first == 20; },
+                       [&calls](std::pair<int, int> &value) {
+            if (++calls == 3)
+            {
+                throw std::runtime_error("operation failed");
+            }
+            value.first = 1;
+        });
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    ASSERT_TEST(intact());
+    int lowered = 0;
+    for (const std::pair<int, int> &value : list)
+    {
+        lowered += (value.first == 1);
+    }
+    ASSERT_TEST(lowered == 2 && (*list.begin()).first == 20);
+    try
+    {
+        list.update(list.begin(), [](std::pair<int, int> &value) {
+            value.first = -1;
+            throw std::runtime_error("operation failed");
+        });
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    ASSERT_TEST(intact());
+    auto last = list.begin();
+    for (int i = 0; i < 5; ++i)
+    {
+        ++last;
+    }
+    ASSERT_TEST((*last).first == -1);
+
+    return true;
+}
+
+bool testPersonBumpPriorities()
+{
+    Person person("Alice");
+    const TaskType types[] = {TaskType::Testing, TaskType::Development, TaskType::Testing,
+                              TaskType::Meeting, TaskType::Testing};
+    const int priorities[] = {40, 60, 90, 70, 10};
+    for (int i = 0; i < 5; ++i)
+    {
+        Task task(priorities[i], types[i], "Task " + std::to_string(i));
+        task.setId(i);
+        person.assignTask(task);
+    }
+
+    // Only the tasks of the type move, and priorities stay within [0, 100]
+    person.bumpTaskPriorities(TaskType::Testing, 20);
+    ASSERT_TEST(person.getTasks().length() == 5 && person.getHighestPriorityTask().getId() == 2);
+    ASSERT_TEST(person.getHighestPriorityTask().getPriority() == 100);
+    person.bumpTaskPriorities(TaskType::Testing, -200);
+    person.bumpTaskPriorities(TaskType::Research, 50);
+    int previous = 100;
+    for (const Task &task : person.getTasks())
+    {
+        ASSERT_TEST(task.getPriority() <= previous);
+        ASSERT_TEST(task.getPriority() == (task.getType() == TaskType::Testing ? 0 : priorities[task.getId()]));
+        previous = task.getPriority();
+    }
+    cout << person;
+
+    return true;
+}
+
+bool testListKeyCompare()
+{
+    SortedList<Task> byOperator;
+    SortedList<Task, mtm::KeyGreater<TaskKey>> byKey;
+    const int ids[] = {7, -3, 0, 2147483647, -2147483647 - 1, 7, -1, 12, 1, -3};
+    const int priorities[] = {5, 5, 100, 5, 5, 0, 0, 100, -4, 5};
+    unsigned int seed = 99;
+    for (int round = 0; round < 4; ++round)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            int pick = static_cast<int>((seed >> 16) % 10);
+            // equal tasks get different descriptions, so their order is visible too
+            Task task(priorities[pick], TaskType::General, "Copy " + std::to_string(round * 10 + i));
+            task.setId(ids[pick]);
+            byOperator.insert(task);
+            byKey.insert(task);
+        }
+    }
+
+    // The key gives exactly the order of operator>, with negative IDs before positive ones
+    ASSERT_TEST(byOperator.length() == 40 && byKey.length() == 40);
+    auto other = byKey.begin();
+    for (const Task &task : byOperator)
+    {
+        const Task &keyed = *other;
+        ASSERT_TEST(task.getId() == keyed.getId() && task.getPriority() == keyed.getPriority());
+        ASSERT_TEST(task.getDescription() == keyed.getDescription());
+        ++other;
+    }
+    for (const Task &task : byKey.filtered([](const Task &task) { return task.getPriority() == 5; }))
+    {
+        cout << task << endl;
+    }
+
+    return true;
+}
+
+bool testListErase()
+{
+    SortedList<int> list;
+    for (int i = 0; i < 10; ++i)
+    {
+        list.insert(i);
+    }
+
+    // Remove from the middle and from both ends through iterators
+    auto it = list.begin();
+    ++it;
+    ++it;
+    list.remove(it);
+    list.remove(list.begin());
+    ASSERT_TEST(list.length() == 8);
+    ASSERT_TEST(*list.begin() == 8);
+
+    // Drop all even values in one pass
+    ASSERT_TEST(list.erase_if([](int value) { return value % 2 == 0; }) == 5);
+    int expected[] = {5, 3, 1};
+    int i = 0;
+    for (int value : list)
+    {
+        ASSERT_TEST(value == expected[i++]);
+    }
+    ASSERT_TEST(i == 3);
+
+    // The list keeps working after the removals
+    list.insert(4);
+    ASSERT_TEST(list.erase_if([](int) { return true; }) == 4);
+    ASSERT_TEST(list.length() == 0);
+    ASSERT_TEST(list.begin() == list.end());
+
+    return true;
+}
+
+// Allocations left before BudgetAllocator throws, unlimited when negative
+int g_allocationBudget = -1;
+
+template <typename T>
+struct BudgetAllocator
+{
+    using value_type = T;
+
+    BudgetAllocator() = default;
+
+    template <typename U>
+    BudgetAllocator(const BudgetAllocator<U> &) {}
+
+    T *allocate(std::size_t count)
+    {
+        if (g_allocationBudget == 0)
+        {
+            throw std::bad_alloc();
+        }
+        if (g_allocationBudget > 0)
+        {
+            g_allocationBudget--;
+        }
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T *pointer, std::size_t count)
+    {
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template <typename U>
+    bool operator==(const BudgetAllocator<U> &) const { return true; }
+
+    template <typename U>
+    bool operator!=(const BudgetAllocator<U> &) const { return false; }
+};
+
+bool testUnrolledListFailures()
+{
+    typedef mtm::UnrolledSortedList<int, mtm::Greater<int>, BudgetAllocator<int>> BudgetList;
+    BudgetList list;
+    for (int i = 0; i < 3000; ++i)
+    {
+        list.insert(i);
+    }
+    BudgetList original(list);
+    auto unchanged = [&list, &original]() {
+        return list.length() == original.length() && list == original;
+    };
+
+    // When the new blocks cannot be had, no element has left its place yet
+    g_allocationBudget = 0;
+    try
+    {
+        list.update_if([](int value) { return value % 3 == 0; }, [](int &value) { value += 7; });
+        return false; // should have thrown exception
+    }
+    catch (const std::bad_alloc &)
+    {
+    }
+    ASSERT_TEST(unchanged());
+    try
+    {
+        list.update(list.find(1500), [](int &value) { value = 20000; });
+        return false; // should have thrown exception
+    }
+    catch (const std::bad_alloc &)
+    {
+    }
+    g_allocationBudget = -1;
+    ASSERT_TEST(unchanged());
+
+    // A throwing operation keeps every element, changed or not
+    int calls = 0;
+    try
+    {
+        list.update_if([](int value) { return value < 100; }, [&calls](int &value) {
+            if (++calls == 50)
+            {
+                throw std::runtime_error("operation failed");
+            }
+            value += 5000;
+        });
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    ASSERT_TEST(list.length() == 3000 && *list.begin() == 5099);
+    try
+    {
+        list.update(list.find(2000), [](int &value) {
+            value = -1;
+            throw std::runtime_error("operation failed");
+        });
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    int previous = *list.begin();
+    int count = 0;
+    for (int value : list)
+    {
+        ASSERT_TEST(value <= previous);
+        previous = value;
+        count++;
+    }
+    ASSERT_TEST(count == 3000 && previous == -1);
+
+    return true;
+}
+
+bool testUnrolledList()
+{
+    mtm::UnrolledSortedList<int> list;
+    // Enough values to spread over several blocks, inserted out of order
+    for (int i = 0; i < 1000; ++i)
+    {
+        list.insert((i * 37) % 1000);
+    }
+    ASSERT_TEST(list.length() == 1000);
+    int expected = 999;
+    for (int value : list)
+    {
+        ASSERT_TEST(value == expected--);
+    }
+    ASSERT_TEST(expected == -1);
+    ASSERT_TEST(*list.find(500) == 500);
+    ASSERT_TEST(list.find(1000) == list.end());
+
+    // Remove through iterators, then in bulk
+    list.remove(list.begin());
+    list.remove(list.find(0));
+    ASSERT_TEST(list.length() == 998);
+    ASSERT_TEST(*list.begin() == 998);
+    ASSERT_TEST(list.erase_if([](int value) { return value % 2 == 0; }) == 499);
+    ASSERT_TEST(list.length() == 499);
+
+    // Same contents as a SortedList built from the same values
+    SortedList<int> reference;
+    for (int value : list)
+    {
+        reference.insert(value);
+    }
+    auto odd = list.filter([](int value) { return value % 4 == 1; });
+    auto referenceOdd = reference.filter([](int value) { return value % 4 == 1; });
+    ASSERT_TEST(odd.length() == referenceOdd.length());
+    auto it = referenceOdd.begin();
+    for (int value : odd)
+    {
+        ASSERT_TEST(value == *it++);
+    }
+
+    // Moving an element keeps the order
+    list.update(list.begin(), [](int &value) { value = -value; });
+    ASSERT_TEST(*list.begin() == 995);
+    mtm::UnrolledSortedList<int> copy = list;
+    ASSERT_TEST(copy == list);
+
+    mtm::UnrolledSortedList<int> empty;
+    try
+    {
+        *empty.begin();
+        return false;
+    }
+    catch (const std::out_of_range &)
+    {
+    }
+
+    return true;
+}
+
+bool testTaskScan()
+{
+    // Keys of a list in list order, with runs of equal priorities and a few duplicates
+    std::vector<std::uint64_t> keys;
+    std::vector<TaskType> types;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Task task(100 - i / 25, static_cast<TaskType>(i % 7));
+        task.setId(i - i % 3);
+        keys.push_back(TaskKey()(task));
+        types.push_back(task.getType());
+    }
+
+    const ScanLevel levels[] = {ScanLevel::Scalar, ScanLevel::Sse42, ScanLevel::Avx2};
+    ScanLevel original = getScanLevel();
+    std::vector<std::uint32_t> positions(types.size());
+    for (ScanLevel level : levels)
+    {
+        setScanLevel(level);
+        for (std::size_t count : {std::size_t(0), std::size_t(1), std::size_t(37), keys.size()})
+        {
+            for (std::size_t i = 0; i < keys.size(); i += 7)
+            {
+                for (std::uint64_t key : {keys[i], keys[i] + 1, keys[i] - 1})
+                {
+                    std::size_t expected = 0;
+                    while (expected < count && keys[expected] > key)
+                    {
+                        ++expected;
+                    }
+                    ASSERT_TEST(scanInsertionPoint(keys.data(), count, key) == expected);
+                }
+            }
+            std::size_t found = scanTasksOfType(types.data(), count, TaskType::Testing, positions.data());
+            std::size_t expected = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (types[i] == TaskType::Testing)
+                {
+                    ASSERT_TEST(expected < found && positions[expected] == i);
+                    ++expected;
+                }
+            }
+            ASSERT_TEST(found == expected);
+        }
+    }
+    setScanLevel(original);
+
+    return true;
+}
+
+bool testListViews()
+{
+    SortedList<int> list;
+    for (int i = 0; i < 10; ++i)
+    {
+        list.insert(i);
+    }
+
+    // Views follow changes to the list, since nothing is copied
+    int calls = 0;
+    auto odd = list.filtered([&calls](int value) {
+        ++calls;
+        return value % 2 == 1;
+    });
+    ASSERT_TEST(calls == 0);
+    int expected[] = {9, 7, 5, 3, 1};
+    int i = 0;
+    for (int value : odd)
+    {
+        ASSERT_TEST(value == expected[i++]);
+    }
+    ASSERT_TEST(i == 5);
+    list.insert(11);
+    ASSERT_TEST(*odd.begin() == 11);
+
+    // A transformation reverses the order here, so the resulting list is sorted again
+    auto negated = odd.transformed([](int value) { return -value; });
+    ASSERT_TEST(*negated.begin() == -11);
+    SortedList<int> sorted = negated.toList();
+    ASSERT_TEST(sorted.length() == 6);
+    ASSERT_TEST(*sorted.begin() == -1);
+
+    // Materialising gives the same lists as the eager versions
+    auto isSmall = [](int value) { return value < 5; };
+    auto doubled = [](int value) { return value * 2; };
+    ASSERT_TEST(list.filtered(isSmall).toList() == list.filter(isSmall));
+    ASSERT_TEST(list.transformed(doubled).toList() == list.apply(doubled));
+    ASSERT_TEST(list.filtered(isSmall).transformed(doubled).toList() == list.filter(isSmall).apply(doubled));
+    ASSERT_TEST(list.transformed(doubled).filtered(isSmall).toList() == list.apply(doubled).filter(isSmall));
+
+    // Filtering a transformation computes every element only once
+    int transforms = 0;
+    auto counted = list.transformed([&transforms](int value) {
+        transforms++;
+        return value * 3;
+    }).filtered([](int value) { return value % 2 == 0; });
+    int sum = 0;
+    for (int value : counted)
+    {
+        sum += value;
+    }
+    ASSERT_TEST(transforms == list.length() && sum == 3 * (8 + 6 + 4 + 2 + 0));
+
+    auto end = odd.end();
+    try
+    {
+        *end;
+        return false;
+    }
+    catch (const std::out_of_range &)
+    {
+    }
+    try
+    {
+        *counted.end();
+        return false;
+    }
+    catch (const std::out_of_range &)
+    {
+    }
+
+    return true;
+}
+
+bool testListParallel()
+{
+    SortedList<int> list;
+    for (int i = 0; i < 5000; ++i)
+    {
+        list.insert((i * 7919) % 1000);
+    }
+
+    // Threshold 0 forces the parallel path even for a short list
+    mtm::ThreadPool pool(3);
+    mtm::ParallelPolicy policy(0, &pool);
+    auto isOdd = [](int value) { return value % 2 == 1; };
+    auto folded = [](int value) { return value % 10; };
+    ASSERT_TEST(list.filter(isOdd, policy) == list.filter(isOdd));
+    ASSERT_TEST(list.apply(folded, policy) == list.apply(folded));
+    ASSERT_TEST(list.filter(isOdd, policy).length() == 2500);
+
+    // Exceptions from the workers reach the caller
+    try
+    {
+        list.apply([](int value) {
+            if (value == 500)
+            {
+                throw std::runtime_error("bad value");
+            }
+            return value;
+        }, policy);
+        return false;
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+
+    return true;
+}
+
 bool testListExceptions()
 {
     using mtm::SortedList;
@@ -404,6 +1186,475 @@ bool testTaskManager()
     return true;
 }
 
+bool testTaskManagerById()
+{
+    TaskManager manager;
+    manager.assignTask("Alice", Task(5, TaskType::Testing, "Write unit tests"));
+    manager.assignTask("Bob", Task(3, TaskType::Development, "Fix bug in UI"));
+    manager.assignTask("Alice", Task(8, TaskType::Meeting, "Weekly team meeting"));
+    manager.assignTask("Bob", Task(1, TaskType::Testing, "Run system tests"));
+
+    manager.cancelTaskById(2);
+    manager.setPriorityById(3, 50);
+    manager.completeTaskById(1);
+    try
+    {
+        manager.completeTaskById(1);
+        return false; // should have thrown exception
+    }
+    catch (std::runtime_error &e)
+    {
+    }
+
+    manager.printAllTasks();
+    cout << endl;
+    manager.printTasksByType(TaskType::Testing);
+    cout << endl;
+
+    manager.completeTask("Bob");
+    manager.printAllEmployees();
+
+    return true;
+}
+
+bool testTaskManagerConcurrent()
+{
+    TaskManager manager(true, true);
+    const int threadCount = 4;
+    const int perThread = 500;
+
+    // Every thread has its own employee and shares one with the others
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&manager, t]() {
+            std::string own = "Worker" + std::to_string(t);
+            for (int i = 0; i < perThread; ++i)
+            {
+                manager.assignTask(own, Task(i % 100, TaskType::Development, "Build module"));
+                manager.assignTask("Shared", Task(i % 50, TaskType::Testing, "Run system tests"));
+                if (i % 2 == 1)
+                {
+                    manager.completeTask(own);
+                    manager.completeTask("Shared");
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Half of the tasks are left, and each of them is removed once however the threads race for it
+    std::atomic<int> removed(0);
+    threads.clear();
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&manager, &removed]() {
+            for (int id = 0; id < 2 * threadCount * perThread; ++id)
+            {
+                try
+                {
+                    manager.setPriorityById(id, 1);
+                    manager.cancelTaskById(id);
+                    removed++;
+                }
+                catch (const std::runtime_error &)
+                {
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_TEST(removed == threadCount * perThread);
+
+    try
+    {
+        manager.completeTask("Shared");
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+
+    return true;
+}
+
+bool testTaskIntake()
+{
+    // Submissions from one thread are assigned in order
+    TaskManager manager(false, true);
+    {
+        TaskIntake intake(manager);
+        intake.submit("Alice", Task(5, TaskType::Testing, "Write unit tests"));
+        intake.submit("Bob", Task(3, TaskType::Development, "Fix bug in UI"));
+        intake.submit("Alice", Task(8, TaskType::Meeting, "Weekly team meeting"));
+        intake.flush();
+        manager.printAllTasks();
+        cout << endl;
+    }
+
+    // A tiny ring makes the producers wait for room
+    TaskManager shared(false, true);
+    const int threadCount = 4;
+    const int perThread = 1000;
+    {
+        TaskIntake intake(shared, 8, 4);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&intake, t]() {
+                std::string name = "Worker" + std::to_string(t % 2);
+                for (int i = 0; i < perThread; ++i)
+                {
+                    intake.submit(name, Task(i % 100, TaskType::General, "Review pull request"));
+                }
+            });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        intake.flush();
+        Task task(1, "Clean up code");
+        while (intake.trySubmit("Worker0", std::move(task)) == false)
+        {
+        }
+    }
+    int removed = 0;
+    for (int id = 0; id <= threadCount * perThread; ++id)
+    {
+        shared.completeTaskById(id);
+        removed++;
+    }
+    ASSERT_TEST(removed == threadCount * perThread + 1);
+
+    return true;
+}
+
+bool testTaskManagerBatch()
+{
+    TaskManager manager;
+    manager.assignTask("Alice", Task(5, TaskType::Testing, "Write unit tests"));
+    std::vector<std::pair<std::string, Task>> batch;
+    batch.emplace_back("Bob", Task(3, TaskType::Development, "Fix bug in UI"));
+    batch.emplace_back("Alice", Task(8, TaskType::Meeting, "Weekly team meeting"));
+    batch.emplace_back("Carol", Task(5, TaskType::Testing, "Run system tests"));
+    batch.emplace_back("Bob", Task(3, TaskType::Documentation, "Update user guide"));
+    batch.emplace_back("Alice", Task(1, TaskType::General, "Clean up code"));
+    manager.assignTasks(std::move(batch));
+    manager.assignTask("Carol", Task(9, TaskType::Development, "Implement new feature"));
+
+    manager.printAllTasks();
+    cout << endl;
+    manager.printTasksByType(TaskType::Testing);
+    cout << endl;
+
+    ASSERT_TEST(manager.completeTasks("Alice", 2) == 2);
+    ASSERT_TEST(manager.completeTasks("Bob", 10) == 2);
+    ASSERT_TEST(manager.completeTasks("Dave", 1) == 0);
+    manager.printAllEmployees();
+
+    return true;
+}
+
+bool testTaskManagerStealing()
+{
+    TaskManager manager;
+    manager.assignTask("Alice", Task(5, TaskType::Testing, "Write unit tests"));
+    manager.assignTask("Alice", Task(8, TaskType::Meeting, "Weekly team meeting"));
+    manager.assignTask("Alice", Task(3, TaskType::Development, "Fix bug in UI"));
+    manager.assignTask("Alice", Task(1, TaskType::General, "Clean up code"));
+    manager.assignTask("Bob", Task(4, TaskType::Testing, "Run system tests"));
+    manager.assignTask("Carol", Task(2, TaskType::Documentation, "Write README"));
+    manager.completeTask("Carol");
+
+    // Carol is idle and takes Alice's top task, Bob is one behind and takes the next one
+    ASSERT_TEST(manager.stealTask("Carol"));
+    ASSERT_TEST(manager.stealTask("Bob"));
+    ASSERT_TEST(!manager.stealTask("Bob"));
+    ASSERT_TEST(manager.getTaskCount("Alice") == 2);
+    ASSERT_TEST(manager.getTaskCount("Bob") == 2);
+    ASSERT_TEST(manager.getTaskCount("Carol") == 1);
+    manager.printAllEmployees();
+    manager.printTasksByType(TaskType::Testing);
+    cout << endl;
+
+    // With work stealing an idle person completes a task of the most loaded one
+    manager.setWorkStealing(true);
+    manager.completeTask("Carol");
+    manager.completeTask("Carol");
+    ASSERT_TEST(manager.getTaskCount("Alice") == 1);
+    manager.setWorkStealing(false);
+    try
+    {
+        manager.completeTask("Carol");
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    manager.printAllTasks();
+
+    return true;
+}
+
+bool testTaskManagerSnapshot()
+{
+    TaskManager manager(true);
+    manager.assignTask("Alice", Task(5, TaskType::Testing, "Write unit tests"));
+    manager.assignTask("Bob", Task(3, TaskType::Development, "Fix bug in UI"));
+    manager.assignTask("Alice", Task(8, TaskType::Meeting, "Weekly team meeting"));
+    manager.assignTask("Bob", Task(5, TaskType::Testing, "Write unit tests"));
+    manager.assignTask("Carol", Task(1, TaskType::General));
+    manager.assignTask("Dave", Task(2, TaskType::Research, "Evaluate tools"));
+    manager.completeTask("Dave");
+    manager.setPriorityById(1, 9);
+    manager.bumpPriorityByType(TaskType::Testing, 2);
+
+    std::stringstream snapshot;
+    manager.saveSnapshot(snapshot);
+    TaskManager loaded;
+    loaded.loadSnapshot(snapshot);
+    std::stringstream saved_again;
+    loaded.saveSnapshot(saved_again);
+    ASSERT_TEST(saved_again.str() == snapshot.str());
+    loaded.printAllEmployees();
+    loaded.printTasksByType(TaskType::Testing);
+    cout << endl;
+
+    // The loaded manager goes on where the saved one stopped
+    loaded.assignTask("Dave", Task(7, TaskType::Testing, "Run system tests"));
+    loaded.completeTaskById(0);
+    loaded.printAllTasks();
+    cout << endl;
+
+    // A manager with employees does not load, and a damaged snapshot leaves nothing behind
+    snapshot.clear();
+    snapshot.seekg(0);
+    try
+    {
+        loaded.loadSnapshot(snapshot);
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    std::string damaged = snapshot.str();
+    damaged.resize(damaged.size() - 3);
+    std::stringstream truncated(damaged);
+    TaskManager empty;
+    try
+    {
+        empty.loadSnapshot(truncated);
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    ASSERT_TEST(empty.getTaskCount("Alice") == 0);
+    empty.printAllEmployees();
+
+    return true;
+}
+
+bool testSnapshotReader()
+{
+    TaskManager manager(true);
+    manager.assignTask("Alice", Task(5, TaskType::Testing, "Write unit tests"));
+    manager.assignTask("Bob", Task(3, TaskType::Development, "Fix bug in UI"));
+    manager.assignTask("Alice", Task(8, TaskType::Meeting, "Weekly team meeting"));
+    manager.assignTask("Bob", Task(5, TaskType::Testing, "Write unit tests"));
+    manager.assignTask("Carol", Task(1, TaskType::General, ""));
+    manager.assignTask("Alice", Task(2, TaskType::Testing, "Run system tests"));
+    manager.bumpPriorityByType(TaskType::Testing, 1);
+    const std::string path = "test_snapshot.bin";
+    manager.saveSnapshot(path);
+
+    // The reader walks the same lists the manager prints
+    std::stringstream expected;
+    std::streambuf *original = std::cout.rdbuf(expected.rdbuf());
+    manager.printAllEmployees();
+    manager.printTasksByType(TaskType::Testing);
+    std::cout.rdbuf(original);
+    std::stringstream actual;
+    {
+        SnapshotReader reader(path);
+        ASSERT_TEST(reader.getTaskCount() == 6 && reader.getPersonCount() == 3 && reader.getNextTaskId() == 6);
+        for (std::size_t person = 0; person < reader.getPersonCount(); ++person)
+        {
+            actual << "Person: " << reader.getPersonName(person) << endl;
+            for (const SnapshotReader::TaskView &task : reader.getTasks(person))
+            {
+                actual << task << endl;
+            }
+            actual << endl;
+        }
+        SnapshotReader::Range testing = reader.getTasksByType(TaskType::Testing);
+        for (SnapshotReader::ConstIterator it = testing.begin(); it != testing.end(); ++it)
+        {
+            actual << *it << endl;
+        }
+        ASSERT_TEST(testing.length() == 3 && reader.getTasksByType(TaskType::Research).length() == 0);
+        ASSERT_TEST(reader.findPerson("Bob") == 1 && reader.findPerson("Dave") == -1);
+        ASSERT_TEST((*reader.getTasks(reader.findPerson("Bob")).begin()).getDescription() == "Write unit tests");
+        try
+        {
+            ++testing.end();
+            return false; // should have thrown exception
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+    }
+    cout << actual.str();
+    ASSERT_TEST(actual.str() == expected.str());
+
+    // Anything but a whole snapshot is refused when it is opened
+    {
+        std::ofstream other(path, std::ios::binary | std::ios::trunc);
+        other << "Not a snapshot, just some text that is long enough to hold a header.";
+    }
+    try
+    {
+        SnapshotReader reader(path);
+        std::remove(path.c_str());
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+    std::remove(path.c_str());
+    try
+    {
+        SnapshotReader reader(path);
+        return false; // should have thrown exception
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+
+    return true;
+}
+
+bool testStringPool()
+{
+    StringPool pool;
+    StringPool::Handle first = pool.intern("Write unit tests");
+    std::string text = "Write unit tests";
+    StringPool::Handle second = pool.intern(text);
+    ASSERT_TEST(first == second && pool.size() == 1);
+    ASSERT_TEST(pool.intern("Fix bug in UI") != first && pool.size() == 2);
+
+    // Tasks built from the pool share its copy, an empty description is never pooled
+    Task interned(5, TaskType::Testing, pool, "Write unit tests");
+    Task sibling(3, TaskType::Development, pool, text);
+    ASSERT_TEST(&interned.getDescription() == first.get() && &sibling.getDescription() == first.get());
+    Task empty(1, TaskType::General, pool, "");
+    ASSERT_TEST(empty.getDescription().empty() && pool.size() == 2);
+
+    // Interning a private description moves it into the pool
+    Task task(4, TaskType::Research, "Evaluate tools");
+    task.internDescription(pool);
+    ASSERT_TEST(pool.size() == 3 && &task.getDescription() == pool.intern("Evaluate tools").get());
+
+    // Copies and assignments between private and interned tasks keep their descriptions
+    Task copy(interned);
+    ASSERT_TEST(&copy.getDescription() == first.get());
+    Task plain(2, TaskType::Meeting, "Weekly team meeting");
+    copy = plain;
+    ASSERT_TEST(copy.getDescription() == "Weekly team meeting" && &copy.getDescription() != &plain.getDescription());
+    plain = std::move(sibling);
+    ASSERT_TEST(&plain.getDescription() == first.get() && plain.getPriority() == 3);
+
+    // A task moved out of its handle still reads as an empty description
+    ASSERT_TEST(sibling.getDescription().empty());
+    {
+        Task moved(std::move(plain));
+        ASSERT_TEST(&moved.getDescription() == first.get() && plain.getDescription().empty());
+        Task target(interned);
+        target = std::move(moved);
+        ASSERT_TEST(&target.getDescription() == first.get() && moved.getDescription().empty());
+    }
+    sibling = Task(6, TaskType::Training, "Onboarding");
+    ASSERT_TEST(sibling.getDescription() == "Onboarding");
+
+    // Purging drops exactly the strings nobody else holds
+    first.reset();
+    second.reset();
+    ASSERT_TEST(pool.purge() == 1 && pool.size() == 2);
+    interned = Task(5, TaskType::Testing, "Write unit tests");
+    plain = interned;
+    task = Task(0, TaskType::General, "");
+    ASSERT_TEST(pool.purge() == 2 && pool.size() == 0);
+    ASSERT_TEST(plain.getDescription() == "Write unit tests");
+
+    return true;
+}
+
+bool testTaskQueue()
+{
+    auto makeTask = [](int id, int priority) {
+        Task task(priority, TaskType::General, "Task " + std::to_string(id));
+        task.setId(id);
+        return task;
+    };
+    auto sameIds = [](const TaskQueue &queue, const std::vector<int> &ids) {
+        std::vector<int> actual;
+        for (const Task &task : queue)
+        {
+            actual.push_back(task.getId());
+        }
+        return actual == ids && queue.length() == static_cast<int>(ids.size());
+    };
+
+    // Buckets go from the highest priority down, equal priorities in ID order
+    TaskQueue queue;
+    queue.insert(makeTask(3, 5));
+    queue.insert(makeTask(10, 9));
+    queue.insert(makeTask(5, 5));
+    queue.insert(makeTask(6, 0));
+    TaskQueue::ConstIterator seven = queue.insert(makeTask(7, 5));
+    queue.insert(makeTask(8, 100));
+    ASSERT_TEST(sameIds(queue, {8, 10, 3, 5, 7, 6}));
+
+    // A task with a lower ID than its bucket goes in front of it, a middle one in between
+    queue.insert(makeTask(1, 5));
+    TaskQueue::ConstIterator four = queue.insert(makeTask(4, 5));
+    queue.insert(makeTask(2, 0));
+    ASSERT_TEST(sameIds(queue, {8, 10, 1, 3, 4, 5, 7, 2, 6}));
+    for (const Task &task : queue)
+    {
+        cout << task << endl;
+    }
+
+    // Removing through iterators keeps the other positions valid
+    queue.remove(four);
+    queue.remove(queue.begin());
+    ASSERT_TEST(sameIds(queue, {10, 1, 3, 5, 7, 2, 6}));
+    ASSERT_TEST((*seven).getId() == 7);
+    queue.remove(seven);
+    queue.remove(queue.begin());
+    ASSERT_TEST(sameIds(queue, {1, 3, 5, 2, 6}));
+    queue.insert(makeTask(9, 5));
+    ASSERT_TEST(sameIds(queue, {1, 3, 5, 9, 2, 6}));
+
+    // Changing a priority moves the task into its new bucket by ID
+    queue.update(queue.begin(), [](Task &task) { task.setPriority(0); });
+    ASSERT_TEST(sameIds(queue, {3, 5, 9, 1, 2, 6}));
+    while (queue.length() > 0)
+    {
+        queue.remove(queue.begin());
+    }
+    ASSERT_TEST(queue.begin() == queue.end());
+
+    return true;
+}
+
 bool testTaskManagerAssignTask()
 {
     TaskManager manager;
@@ -436,13 +1687,12 @@ bool testTaskManagerAssignTask()
     manager.assignTask("Hank", task9);
     manager.assignTask("Bonie", task10);
 
-    try
-    {
-        manager.assignTask("boom", task11);
-        return false; // should have thrown exception
-    }
-    catch (std::exception &e)
+    // there is no limit on the number of persons
+    manager.assignTask("boom", task11);
+    for (int i = 0; i < 1000; ++i)
     {
+        manager.assignTask("Person" + std::to_string(i), task12);
+        manager.completeTask("Person" + std::to_string(i));
     }
 
     manager.assignTask("Bob", task12);
@@ -472,7 +1722,29 @@ bool testTaskManagerAssignTask()
     X(testTaskManager)                       \
     X(testCopyConstructorExceptionSafety)    \
     X(testTaskManagerAssignTask)             \
-    X(testTaskManagerPrintTasksByType)
+    X(testTaskManagerPrintTasksByType)       \
+    X(testListMove)                          \
+    X(testListMerge)                         \
+    X(testListErase)                         \
+    X(testTaskManagerById)                   \
+    X(testUnrolledList)                      \
+    X(testTaskScan)                          \
+    X(testListViews)                         \
+    X(testListParallel)                      \
+    X(testTaskManagerConcurrent)             \
+    X(testTaskIntake)                        \
+    X(testTaskManagerBatch)                  \
+    X(testTaskManagerStealing)               \
+    X(testTaskManagerSnapshot)               \
+    X(testSnapshotReader)                    \
+    X(testListPoolAllocator)                 \
+    X(testListBulkInsert)                    \
+    X(testStringPool)                        \
+    X(testTaskQueue)                         \
+    X(testListKeyCompare)                    \
+    X(testUnrolledListFailures)              \
+    X(testListUpdate)                        \
+    X(testPersonBumpPriorities)
 
 
 testFunc tests[] = {